@@ -0,0 +1,32 @@
+/******************************************************************************
+ *  Header:       allowlist.h
+ *  Dependencies: fastIO.h parallel.h radixSort.h
+ *
+ *  Loads an allowlist file into a sorted array of distinct keys.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_ALLOWLIST_H_
+#define FUNDAMENTALS_ALLOWLIST_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "fastIO.h"
+#include "parallel.h"
+#include "radixSort.h"
+
+// Reads all integers from in and returns them in ascending order with
+// duplicates removed, using the given number of threads: the text is
+// parsed in parallel pieces into an array sized from the file length,
+// sorted with the parallel radixSort and deduplicated in one pass.
+//
+// Dropping duplicates does not change which keys any search finds.
+inline std::vector<int> loadAllowlist(In& in, int threads = defaultThreads()) {
+  std::vector<int> arr = in.readAllInts(threads);
+  radixSort(&arr, threads);
+  arr.erase(std::unique(arr.begin(), arr.end()), arr.end());
+  return arr;
+}
+
+#endif // FUNDAMENTALS_ALLOWLIST_H_
@@ -0,0 +1,394 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread benchSuite.cc -o benchSuite
+ *  Execution:  ./benchSuite [n]
+ *              ./benchSuite gen random|chain|grid|powerlaw n [m]
+ *  Dependencies: workloads.h perfCounters.h stopwatch.h fastIO.h
+ *                unionFind.h quickFindUF.h packedUnionFind.h
+ *                growableUnionFind.h rollbackUnionFind.h
+ *                componentUnionFind.h mappedUnionFind.h concurrentUF.h
+ *                connectedComponents.h bsearch.h bsearchBatch.h
+ *                eytzinger.h simdSearch.h learnedIndex.h eliasFano.h
+ *                bitmapSet.h flatHashSet.h bloomFilter.h
+ *
+ *  Every union-find class on every workload of workloads.h at scale n
+ *  (default 1M), then every allowlist lookup on an allowlist of n keys.
+ *  The workloads are generated deterministically, so two runs, on two
+ *  machines, measure the same input; gen prints one in the union-find
+ *  input format, for the drivers or for other implementations.
+ *
+ *    - random:   2n uniformly random pairs
+ *    - chain:    the pairs (0, i), adversarial for plain quick-union and
+ *                quick-find; at most 25000 elements, so that those run
+ *    - grid:     percolation edges on a sqrt(n)-by-sqrt(n) grid
+ *    - powerlaw: 2n edges with power-law degrees
+ *
+ *  For each class: nanoseconds per pair of the client loop (find both,
+ *  merge if different), last-level cache misses and instructions per
+ *  pair when the machine exposes hardware counters ("-" otherwise), the
+ *  height of the tallest tree left behind and the number of components.
+ *  Quick-find and plain quick-union are skipped above 100000 elements.
+ *  For the lookups, half of the n queries hit, and the last column
+ *  counts the hits (the Bloom filter's includes its false positives).
+ *
+ *  % ./benchSuite
+ *  (no hardware counters on this machine: miss/op and instr/op show -)
+ *  workload  structure                 ns/op  miss/op instr/op  height components
+ *  random    QuickFindUF             skipped  (quadratic above 100000 elements)
+ *  random    QuickUnionUF            skipped  (quadratic above 100000 elements)
+ *  random    QuickUnionPathCompr       140.9        -        -       7      19004
+ *  random    WeightedQuickUnionUF       59.3        -        -       9      19004
+ *  random    WeightedQUPathCompr        43.6        -        -       3      19004
+ *  random    UF (rank, halving)         29.2        -        -       4      19004
+ *  random    UF mergeBatch              28.4        -        -       4      19004
+ *  random    PackedUnionFind            42.7        -        -       4      19004
+ *  random    RollbackUnionFind          66.2        -        -       9      19004
+ *  random    ComponentUnionFind         36.9        -        -       4      19004
+ *  random    ConcurrentUF               52.8        -        -       4      19004
+ *  random    GrowableUnionFind         405.0        -        -       4      19004
+ *  random    MappedUnionFind            46.9        -        -       3      19004
+ *  random    afforest components        33.7        -        -       1      19004
+ *  chain     QuickFindUF             23303.8        -        -       -          1
+ *  chain     QuickUnionUF            68135.2        -        -   24999          1
+ *  chain     QuickUnionPathCompr        11.7        -        -   24998          1
+ *  chain     WeightedQuickUnionUF        5.7        -        -       1          1
+ *  chain     WeightedQUPathCompr         7.9        -        -       1          1
+ *  chain     UF (rank, halving)          6.8        -        -       1          1
+ *  chain     UF mergeBatch              11.7        -        -       1          1
+ *  chain     PackedUnionFind             8.2        -        -       1          1
+ *  chain     RollbackUnionFind           8.0        -        -       1          1
+ *  chain     ComponentUnionFind          6.5        -        -       1          1
+ *  chain     ConcurrentUF               24.6        -        -      13          1
+ *  chain     GrowableUnionFind          54.2        -        -       1          1
+ *  chain     MappedUnionFind            11.7        -        -       1          1
+ *  chain     afforest components        28.8        -        -       1          1
+ *  grid      QuickFindUF             skipped  (quadratic above 100000 elements)
+ *  grid      QuickUnionUF            skipped  (quadratic above 100000 elements)
+ *  grid      QuickUnionPathCompr        46.4        -        -      12     425945
+ *  grid      WeightedQuickUnionUF       45.8        -        -      10     425945
+ *  grid      WeightedQUPathCompr        47.7        -        -       7     425945
+ *  grid      UF (rank, halving)         35.7        -        -       6     425945
+ *  grid      UF mergeBatch              44.7        -        -       6     425945
+ *  grid      PackedUnionFind            39.2        -        -       7     425945
+ *  grid      RollbackUnionFind          48.1        -        -      10     425945
+ *  grid      ComponentUnionFind         46.7        -        -       7     425945
+ *  grid      ConcurrentUF               61.2        -        -       8     425945
+ *  grid      GrowableUnionFind         474.0        -        -       7     425945
+ *  grid      MappedUnionFind            59.2        -        -       7     425945
+ *  grid      afforest components        58.5        -        -       1     425945
+ *  powerlaw  QuickFindUF             skipped  (quadratic above 100000 elements)
+ *  powerlaw  QuickUnionUF            skipped  (quadratic above 100000 elements)
+ *  powerlaw  QuickUnionPathCompr       143.3        -        -      14     488633
+ *  powerlaw  WeightedQuickUnionUF       33.7        -        -       4     488633
+ *  powerlaw  WeightedQUPathCompr        30.4        -        -       3     488633
+ *  powerlaw  UF (rank, halving)         18.6        -        -       3     488633
+ *  powerlaw  UF mergeBatch              24.3        -        -       3     488633
+ *  powerlaw  PackedUnionFind            22.6        -        -       3     488633
+ *  powerlaw  RollbackUnionFind          37.5        -        -       4     488633
+ *  powerlaw  ComponentUnionFind         27.0        -        -       3     488633
+ *  powerlaw  ConcurrentUF               27.1        -        -       4     488633
+ *  powerlaw  GrowableUnionFind         277.7        -        -       3     488633
+ *  powerlaw  MappedUnionFind            33.8        -        -       3     488633
+ *  powerlaw  afforest components        33.3        -        -       1     488633
+ *  workload  lookup                    ns/op  miss/op instr/op               hits
+ *  allowlist bsearch                   251.5        -        -       -     529557
+ *  allowlist eytzinger                 105.5        -        -       -     529557
+ *  allowlist simd                      181.7        -        -       -     529557
+ *  allowlist batch                      37.1        -        -       -     529557
+ *  allowlist learned                    99.3        -        -       -     529557
+ *  allowlist eliasfano                 124.5        -        -       -     529557
+ *  allowlist bitmap                      3.4        -        -       -     529557
+ *  allowlist hash                       30.6        -        -       -     529557
+ *  allowlist bloom                      20.5        -        -       -     530160
+ *
+ *  (single-core machine with a 300 MB last-level cache and no hardware
+ *  counters exposed to the guest, hence the dashes; timings vary by about
+ *  10% between runs. GrowableUnionFind pays two hash lookups per pair,
+ *  and the chain rows show the linear height that makes plain quick-union
+ *  quadratic)
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "bitmapSet.h"
+#include "bloomFilter.h"
+#include "bsearch.h"
+#include "bsearchBatch.h"
+#include "componentUnionFind.h"
+#include "concurrentUF.h"
+#include "connectedComponents.h"
+#include "eliasFano.h"
+#include "eytzinger.h"
+#include "fastIO.h"
+#include "flatHashSet.h"
+#include "growableUnionFind.h"
+#include "learnedIndex.h"
+#include "mappedUnionFind.h"
+#include "packedUnionFind.h"
+#include "perfCounters.h"
+#include "quickFindUF.h"
+#include "rollbackUnionFind.h"
+#include "simdSearch.h"
+#include "stopwatch.h"
+#include "unionFind.h"
+#include "workloads.h"
+
+using workload::UnionFindWorkload;
+
+// Largest n run with quick-find or plain quick-union, which take
+// quadratic time.
+const size_t kMaxQuadratic = 100000;
+
+// Size of the chain workload, small enough for the quadratic classes.
+const size_t kChain = 25000;
+
+// Prints count / ops per operation, or "-" if the count is unknown.
+void printPerOp(long long count, size_t ops) {
+  if (count < 0 || ops == 0) {
+    printf(" %8s", "-");
+  } else {
+    printf(" %8.1f", static_cast<double>(count) / ops);
+  }
+}
+
+// Prints the measurement columns shared by both tables.
+void printMeasures(double seconds, const PerfCounters& counters, size_t ops) {
+  printf(" %8.1f", ops == 0 ? 0.0 : seconds * 1e9 / ops);
+  printPerOp(counters.cacheMisses(), ops);
+  printPerOp(counters.instructions(), ops);
+}
+
+void printSkipped(const UnionFindWorkload& w, const char* structure) {
+  printf("%-9s %-22s %8s  (quadratic above %zu elements)\n", w.name.c_str(), structure,
+         "skipped", kMaxQuadratic);
+}
+
+void printRow(const UnionFindWorkload& w, const char* structure, double seconds,
+              const PerfCounters& counters, long long height, size_t count) {
+  printf("%-9s %-22s", w.name.c_str(), structure);
+  printMeasures(seconds, counters, w.pairs.size());
+  if (height < 0) {
+    printf(" %7s", "-");
+  } else {
+    printf(" %7lld", height);
+  }
+  printf(" %10zu\n", count);
+}
+
+// The height of the trees, for the classes that have them.
+template <typename UF>
+long long heightOf(const UF& uf) { return static_cast<long long>(uf.height()); }
+
+long long heightOf(const QuickFindUF&) { return -1; }
+
+// Runs the dynamic-connectivity client loop over the pairs of w on uf,
+// which has w.n elements, and prints its row.
+template <typename UF>
+void runClient(const UnionFindWorkload& w, const char* structure, UF& uf) {
+  PerfCounters counters;
+  Stopwatch timer;
+  counters.start();
+  for (const auto& e : w.pairs) {
+    if (uf.find(e.first) != uf.find(e.second)) {
+      uf.merge(e.first, e.second);
+    }
+  }
+  counters.stop();
+  double seconds = timer.elapsedTime();
+  printRow(w, structure, seconds, counters, heightOf(uf), static_cast<size_t>(uf.count()));
+}
+
+template <typename UF>
+void run(const UnionFindWorkload& w, const char* structure) {
+  UF uf(w.n);
+  runClient(w, structure, uf);
+}
+
+void runUnionFind(const UnionFindWorkload& w) {
+  if (w.n > kMaxQuadratic) {
+    printSkipped(w, "QuickFindUF");
+    printSkipped(w, "QuickUnionUF");
+  } else {
+    run<QuickFindUF>(w, "QuickFindUF");
+    run<UnionFind<uint32_t, uf::Naive, uf::NoCompression>>(w, "QuickUnionUF");
+  }
+  run<UnionFind<uint32_t, uf::Naive, uf::FullCompression>>(w, "QuickUnionPathCompr");
+  run<UnionFind<uint32_t, uf::BySize, uf::NoCompression>>(w, "WeightedQuickUnionUF");
+  run<UnionFind<uint32_t, uf::BySize, uf::FullCompression>>(w, "WeightedQUPathCompr");
+  run<UnionFind<uint32_t, uf::ByRank, uf::PathHalving>>(w, "UF (rank, halving)");
+
+  {
+    typedef UnionFind<uint32_t, uf::ByRank, uf::PathHalving> UF;
+    std::vector<uint32_t> flat(2 * w.pairs.size());
+    for (size_t i = 0; i < w.pairs.size(); i++) {
+      flat[2 * i] = w.pairs[i].first;
+      flat[2 * i + 1] = w.pairs[i].second;
+    }
+    UF uf(w.n);
+    PerfCounters counters;
+    Stopwatch timer;
+    counters.start();
+    uf.mergeBatch(flat.data(), w.pairs.size());
+    counters.stop();
+    double seconds = timer.elapsedTime();
+    printRow(w, "UF mergeBatch", seconds, counters, heightOf(uf), uf.count());
+  }
+
+  run<PackedUnionFind<int32_t>>(w, "PackedUnionFind");
+  run<RollbackUnionFind<uint32_t>>(w, "RollbackUnionFind");
+  run<ComponentUnionFind<uint32_t>>(w, "ComponentUnionFind");
+  run<ConcurrentUF>(w, "ConcurrentUF");
+
+  {
+    // keys are the elements themselves, so every pair pays two lookups
+    GrowableUnionFind<int32_t> uf;
+    uf.reserve(w.n);
+    for (size_t i = 0; i < w.n; i++) {
+      uf.slotOf(i);
+    }
+    runClient(w, "GrowableUnionFind", uf);
+  }
+
+  {
+    std::string filename = "/tmp/benchSuite." + std::to_string(getpid()) + ".uf";
+    {
+      MappedUnionFind<uint32_t> uf(filename.c_str(), w.n);
+      runClient(w, "MappedUnionFind", uf);
+    }
+    std::remove(filename.c_str());
+  }
+
+  {
+    std::vector<std::pair<int, int>> edges(w.pairs.begin(), w.pairs.end());
+    PerfCounters counters;
+    Stopwatch timer;
+    counters.start();
+    Components c = components(static_cast<int>(w.n), edges);
+    counters.stop();
+    double seconds = timer.elapsedTime();
+    long long height = uf::height(w.n, [&](size_t i) { return c.id[i]; });
+    printRow(w, "afforest components", seconds, counters, height, c.count);
+  }
+}
+
+// Times lookup(i) for every query i and prints its row with the number
+// of hits.
+template <typename Lookup>
+void runLookup(const char* method, size_t queries, Lookup lookup) {
+  PerfCounters counters;
+  Stopwatch timer;
+  counters.start();
+  size_t hits = 0;
+  for (size_t i = 0; i < queries; i++) {
+    hits += lookup(i);
+  }
+  counters.stop();
+  double seconds = timer.elapsedTime();
+  printf("%-9s %-22s", "allowlist", method);
+  printMeasures(seconds, counters, queries);
+  printf(" %7s %10zu\n", "-", hits);
+}
+
+void runAllowlist(size_t n) {
+  std::vector<int> keys = workload::allowlist(n);
+  std::vector<int> q = workload::queries(keys, n, 0.5);
+  const int* a = keys.data();
+  int size = static_cast<int>(keys.size());
+
+  runLookup("bsearch", q.size(), [&](size_t i) { return bsearch(a, size, q[i]) >= 0; });
+  EytzingerIndex eytzinger(keys);
+  runLookup("eytzinger", q.size(), [&](size_t i) { return eytzinger.indexOf(q[i]) >= 0; });
+  runLookup("simd", q.size(), [&](size_t i) { return bsearchSimd(a, size, q[i]) >= 0; });
+
+  {
+    std::vector<int> found;
+    PerfCounters counters;
+    Stopwatch timer;
+    counters.start();
+    bsearchBatch(a, size, q, &found);
+    size_t hits = 0;
+    for (int f : found) {
+      hits += f >= 0;
+    }
+    counters.stop();
+    double seconds = timer.elapsedTime();
+    printf("%-9s %-22s", "allowlist", "batch");
+    printMeasures(seconds, counters, q.size());
+    printf(" %7s %10zu\n", "-", hits);
+  }
+
+  LearnedIndex learned(keys);
+  runLookup("learned", q.size(), [&](size_t i) { return learned.indexOf(q[i]) >= 0; });
+  EliasFano elias_fano(keys);
+  runLookup("eliasfano", q.size(), [&](size_t i) { return elias_fano.indexOf(q[i]) >= 0; });
+  BitmapSet bitmap(keys);
+  runLookup("bitmap", q.size(), [&](size_t i) { return bitmap.contains(q[i]); });
+  FlatHashSet hash(keys);
+  runLookup("hash", q.size(), [&](size_t i) { return hash.contains(q[i]); });
+  BloomFilter bloom(keys);
+  runLookup("bloom", q.size(), [&](size_t i) { return bloom.mayContain(q[i]); });
+}
+
+UnionFindWorkload generate(const std::string& name, size_t n, size_t m) {
+  if (name == "random") {
+    return workload::random(n, m);
+  } else if (name == "chain") {
+    return workload::chain(n);
+  } else if (name == "grid") {
+    size_t side = 1;
+    while ((side + 1) * (side + 1) <= n) {
+      side++;
+    }
+    return workload::grid(side);
+  } else if (name == "powerlaw") {
+    return workload::powerLaw(n, m);
+  }
+  throw std::invalid_argument("unknown workload " + name);
+}
+
+int main(int argc, char* argv[]) {
+  if (argc > 1 && strcmp(argv[1], "gen") == 0) {
+    if (argc < 4) {
+      fprintf(stderr, "usage: %s gen random|chain|grid|powerlaw n [m]\n", argv[0]);
+      return 1;
+    }
+    size_t n = std::stoul(argv[3]);
+    size_t m = argc > 4 ? std::stoul(argv[4]) : 2 * n;
+    if (n == 0 && m > 0) {
+      fprintf(stderr, "%s: pairs need at least one element\n", argv[0]);
+      return 1;
+    }
+    UnionFindWorkload w = generate(argv[2], n, m);
+    Out out;
+    out << static_cast<long long>(w.n) << '\n';
+    for (const auto& e : w.pairs) {
+      out << static_cast<long long>(e.first) << ' ' << static_cast<long long>(e.second) << '\n';
+    }
+    return out.exitStatus();
+  }
+
+  size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  if (!PerfCounters().available()) {
+    printf("(no hardware counters on this machine: miss/op and instr/op show -)\n");
+  }
+  printf("%-9s %-22s %8s %8s %8s %7s %10s\n", "workload", "structure", "ns/op", "miss/op",
+         "instr/op", "height", "components");
+  const char* names[] = { "random", "chain", "grid", "powerlaw" };
+  for (const char* name : names) {
+    size_t size = strcmp(name, "chain") == 0 ? std::min(n, kChain) : n;
+    runUnionFind(generate(name, size, 2 * size));
+  }
+  printf("%-9s %-22s %8s %8s %8s %7s %10s\n", "workload", "lookup", "ns/op", "miss/op",
+         "instr/op", "", "hits");
+  runAllowlist(n);
+  return 0;
+}
@@ -0,0 +1,70 @@
+/******************************************************************************
+ *  Header:       bitmapSet.h
+ *  Dependencies:
+ *
+ *  Set of ints stored as one bit per value of their range.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_BITMAP_SET_H_
+#define FUNDAMENTALS_BITMAP_SET_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The BitmapSet class stores a set of ints as a bit vector over the
+ * range [min, max] of its keys. A membership query is a range check and
+ * one bit test, a single cache miss at most, and the set takes
+ * (max - min + 1) / 8 bytes whatever the number of keys: less than a
+ * sorted array once the keys cover more than 1/32 of their range.
+ *
+ * The constructor takes theta(n + max - min) time; contains takes
+ * constant time.
+ */
+
+class BitmapSet {
+ public:
+  // Builds the set from the array sorted[0..n) in ascending order.
+  BitmapSet(const int* sorted, size_t n) : min_(0), max_(-1) {
+    if (n == 0) {
+      return;
+    }
+    min_ = sorted[0];
+    max_ = sorted[n - 1];
+    bits_.assign(offset(max_) / 64 + 1, 0);
+    for (size_t i = 0; i < n; i++) {
+      uint64_t bit = offset(sorted[i]);
+      bits_[bit / 64] |= uint64_t(1) << (bit % 64);
+    }
+  }
+
+  // Builds the set from an array sorted in ascending order.
+  explicit BitmapSet(const std::vector<int>& sorted)
+      : BitmapSet(sorted.data(), sorted.size()) { }
+
+  // Returns the number of bytes the set occupies.
+  size_t bytes() const { return sizeof(*this) + bits_.capacity() * 8; }
+
+  // Returns true if key is present.
+  bool contains(int key) const {
+    if (key < min_ || key > max_) {
+      return false;
+    }
+    uint64_t bit = offset(key);
+    return bits_[bit / 64] >> (bit % 64) & 1;
+  }
+
+ private:
+  uint64_t offset(int key) const {
+    return static_cast<uint64_t>(static_cast<int64_t>(key) - min_);
+  }
+
+ private:
+  int min_;                       // smallest key
+  int max_;                       // largest key
+  std::vector<uint64_t> bits_;    // bit k is set if min_ + k is a key
+}; // class BitmapSet
+
+#endif // FUNDAMENTALS_BITMAP_SET_H_
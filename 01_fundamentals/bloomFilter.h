@@ -0,0 +1,94 @@
+/******************************************************************************
+ *  Header:       bloomFilter.h
+ *  Dependencies: hashing.h
+ *
+ *  Split-block Bloom filter over ints.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_BLOOM_FILTER_H_
+#define FUNDAMENTALS_BLOOM_FILTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hashing.h"
+
+/**
+ * The BloomFilter class answers "is key possibly in the set?" with no
+ * false negatives and a small rate of false positives, in a fraction of
+ * the space of the set itself. It is meant as a prefilter: when most
+ * queries miss, the filter rejects them before they reach the slower
+ * exact structure behind it.
+ *
+ * It uses the split-block layout (as in Impala and Parquet): the hash of
+ * a key selects one 32-byte block of eight 32-bit words and sets one bit
+ * in each word, chosen by multiplying the hash by eight fixed odd salts.
+ * A query therefore reads a single block, within one cache line, and the
+ * eight word tests have no dependencies between them.
+ *
+ * At the default 16 bits per key the false positive rate is about 0.1%.
+ * The constructor takes theta(n) time; mayContain takes constant time.
+ */
+
+class BloomFilter {
+ public:
+  // Builds the filter from the keys keys[0..n) with about bits_per_key
+  // bits of filter per key.
+  BloomFilter(const int* keys, size_t n, size_t bits_per_key = 16) {
+    size_t blocks = (n * bits_per_key + kBlockBits - 1) / kBlockBits;
+    blocks_.assign(blocks > 0 ? blocks : 1, Block());
+    for (size_t i = 0; i < n; i++) {
+      uint64_t h = hashing::hash(keys[i]);
+      Block& b = blocks_[blockFor(h)];
+      for (int w = 0; w < kWords; w++) {
+        b.word[w] |= bitFor(h, w);
+      }
+    }
+  }
+
+  // Builds the filter from the keys in an array.
+  explicit BloomFilter(const std::vector<int>& keys, size_t bits_per_key = 16)
+      : BloomFilter(keys.data(), keys.size(), bits_per_key) { }
+
+  // Returns the number of bytes the filter occupies.
+  size_t bytes() const { return sizeof(*this) + blocks_.capacity() * sizeof(Block); }
+
+  // Returns false if key is certainly not in the set, true if it may be.
+  bool mayContain(int key) const {
+    uint64_t h = hashing::hash(key);
+    const Block& b = blocks_[blockFor(h)];
+    uint32_t missing = 0;
+    for (int w = 0; w < kWords; w++) {
+      missing |= ~b.word[w] & bitFor(h, w);
+    }
+    return missing == 0;
+  }
+
+ private:
+  static const int kWords = 8;
+  static const size_t kBlockBits = 32 * kWords;
+
+  struct alignas(32) Block {
+    uint32_t word[kWords] = { 0 };
+  };
+
+  // Maps the high half of the hash onto a block without a division.
+  size_t blockFor(uint64_t h) const { return ((h >> 32) * blocks_.size()) >> 32; }
+
+  // Returns the bit to test in word w; the low half of the hash times an
+  // odd salt, whose top 5 bits pick the bit.
+  static uint32_t bitFor(uint64_t h, int w) {
+    static const uint32_t kSalt[kWords] = {
+      0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+      0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U
+    };
+    return uint32_t(1) << ((static_cast<uint32_t>(h) * kSalt[w]) >> 27);
+  }
+
+ private:
+  std::vector<Block> blocks_;
+}; // class BloomFilter
+
+#endif // FUNDAMENTALS_BLOOM_FILTER_H_
@@ -0,0 +1,83 @@
+/******************************************************************************
+ *  Header:       boundedQueue.h
+ *  Dependencies:
+ *
+ *  Blocking FIFO queue of fixed capacity for handing work between threads.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_BOUNDED_QUEUE_H_
+#define FUNDAMENTALS_BOUNDED_QUEUE_H_
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+/**
+ * The BoundedQueue class is a multi-producer, multi-consumer FIFO queue
+ * holding at most capacity items. push blocks while the queue is full and
+ * pop blocks while it is empty, so a fast stage can never run more than
+ * capacity items ahead of a slow one.
+ *
+ * Closing the queue wakes every waiting thread: pending items can still
+ * be popped, after which pop reports the end of the stream.
+ */
+
+template <typename T>
+class BoundedQueue {
+ public:
+  // Initializes an empty, open queue holding at most capacity items.
+  explicit BoundedQueue(size_t capacity) : capacity_(capacity), closed_(false) { }
+
+  BoundedQueue(const BoundedQueue&) = delete;
+  BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+  ~BoundedQueue() { }
+
+  // Appends item, waiting for room. Returns false (dropping item) if
+  // the queue is closed.
+  bool push(T item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_full_.wait(lock, [this] { return closed_ || items_.size() < capacity_; });
+    if (closed_) {
+      return false;
+    }
+    items_.push_back(std::move(item));
+    not_empty_.notify_one();
+    return true;
+  }
+
+  // Removes the oldest item into *item, waiting for one. Returns false
+  // once the queue is closed and drained.
+  bool pop(T* item) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    not_empty_.wait(lock, [this] { return closed_ || !items_.empty(); });
+    if (items_.empty()) {
+      return false;
+    }
+    *item = std::move(items_.front());
+    items_.pop_front();
+    not_full_.notify_one();
+    return true;
+  }
+
+  // Closes the queue; no more items are accepted.
+  void close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    not_empty_.notify_all();
+    not_full_.notify_all();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable not_empty_;
+  std::condition_variable not_full_;
+  std::deque<T> items_;   // items_.front() is the oldest
+  size_t capacity_;       // maximum number of items
+  bool closed_;           // no more pushes accepted
+}; // class BoundedQueue
+
+#endif // FUNDAMENTALS_BOUNDED_QUEUE_H_
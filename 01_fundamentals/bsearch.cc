@@ -1,7 +1,10 @@
 /******************************************************************************
- *  Compilation:  g++ bsearch.cc -o bsearch
- *  Execution:    ./bsearch allowlist.txt < input.txt
- *  Dependencies:
+ *  Compilation:  g++ -O2 -pthread bsearch.cc -o bsearch
+ *  Execution:    ./bsearch allowlist.txt [method [threads]] < input.txt
+ *                ./bsearch build allowlist.txt allowlist.idx [eytzinger]
+ *  Dependencies: allowlist.h bsearch.h bsearchBatch.h bsearchPipeline.h
+ *                eliasFano.h eytzinger.h learnedIndex.h membership.h
+ *                searchIndex.h simdSearch.h fastIO.h opStats.h
  *  Data files:   https://algs4.cs.princeton.edu/11model/tinyW.txt
  *                https://algs4.cs.princeton.edu/11model/tinyT.txt
  *                https://algs4.cs.princeton.edu/11model/largeW.txt
@@ -32,83 +35,204 @@
  *  763178
  *  44696
  *  [9632,055 total values]
- *  
+ *
+ *  The optional method selects the search structure built over the
+ *  allowlist; all of them print the same output:
+ *
+ *    binary      bsearch() over the sorted array (default)
+ *    eytzinger   EytzingerIndex, cache-friendly BFS layout
+ *    simd        bsearchSimd(), AVX2/SSE2 compares in the last levels
+ *    learned     LearnedIndex, piecewise linear model of the key
+ *                positions plus a bounded search around its prediction
+ *    eliasfano   EliasFano, compressed to under a byte per key for
+ *                dense allowlists and searched in place
+ *    bitmap      BitmapSet, one bit per value of the key range
+ *    hash        FlatHashSet, Swiss-table style open addressing
+ *    bloom       BloomFilter rejecting most misses before bsearch()
+ *    auto        whichever of binary, bitmap, hash and bloom
+ *                membership::choose() picks for the allowlist
+ *    batch       bsearchBatch() over blocks of 4096 keys from stdin
+ *    pipeline    filterPipelined(), parser, search threads (default: one
+ *                per hardware thread) and writer running concurrently
+ *
+ *  The allowlist can also be an index file prebuilt by the build command
+ *  (see searchIndex.h). It is mapped instead of parsed and sorted, so the
+ *  filter starts answering at once whatever the allowlist size; with the
+ *  eytzinger option the file also stores the EytzingerIndex layout, which
+ *  the eytzinger method then uses in place.
+ *
+ *  % ./bsearch build hugeW.txt hugeW.idx eytzinger
+ *  % ./bsearch hugeW.idx eytzinger < largeT.txt
+ *
  ******************************************************************************/
 
-#include <iostream>
-#include <vector>
-#include <fstream>
+#include <exception>
+#include <memory>
 #include <string>
-#include <algorithm>
+#include <vector>
 
-// Returns the index of the specified key in the spefified array.
-// @param a the array of the speficed key in the specified array.
-// @param key the search key
-// @return index of key in the {array @code a} if present; {@code -1} otherwise
-int bsearch(const std::vector<int>& arr, int key) {
-  int lo = 0;
-  int hi = arr.size() - 1;
-  while (lo <= hi) {
-    int mid = lo + (hi - lo) / 2;
-    // Key is in arr[lo..hi] or not present.
-    if (key < arr[mid]) {
-      hi = mid - 1;
-    } else if (key > arr[mid]) {
-      lo = mid + 1;
-    } else {
-      return mid;
+#include "allowlist.h"
+#include "bsearch.h"
+#include "bsearchBatch.h"
+#include "bsearchPipeline.h"
+#include "eliasFano.h"
+#include "eytzinger.h"
+#include "fastIO.h"
+#include "learnedIndex.h"
+#include "membership.h"
+#include "opStats.h"
+#include "searchIndex.h"
+#include "simdSearch.h"
+
+//#define DEBUG
+
+// Number of keys read from standard input per bsearchBatch() call.
+const size_t kBlockSize = 4096;
+
+// Reads integers from in and prints to out those for which
+// contains(key) returns true.
+template <typename Contains>
+void filter(In& in, Out& out, Contains contains) {
+  while (!in.isEmpty()) {
+    int key = in.readInt();
+    if (contains(key)) {
+      out << key << '\n';
     }
   }
-  return -1;
 }
 
-//#define DEBUG
-
 // Reads in a sequence of integers from the allowlist file, specified as
 // a command-line argument; reads in integers from standard input;
 // prints to standard output those integers that do <em>not</em> appear in the file.
 // 
 // @param args the command-line arguments
 int main(int argc, char* argv[]) {
+  opstats::dumpJsonAtExit();
+  Out out;
   if (argc < 2) {
-    std::cout << "Usage: ./BinarySearch allowlist.txt < input.txt\n";
-    return 1;
-  }
-  std::fstream in(argv[1]);
-  if (!in.is_open()) {
-    std::cout << "failed to open " << argv[1] << std::endl;
+    out << "Usage: ./BinarySearch allowlist.txt [method [threads]] < input.txt\n";
     return 1;
   }
-  std::vector<int> arr;
-  std::string line;
-  while (!in.eof()) {
-    std::getline(in, line);
-    if (line.empty()) {
-      break;
+  if (std::string(argv[1]) == "build") {
+    if (argc < 4) {
+      out << "Usage: ./BinarySearch build allowlist.txt allowlist.idx [eytzinger]\n";
+      return 1;
+    }
+    In allowlist(argv[2]);
+    if (!allowlist.exists()) {
+      out << "failed to open " << argv[2] << '\n';
+      return 1;
     }
-    int n = std::stoi(line);
-    arr.emplace_back(n);
+    try {
+      bool eytzinger = argc > 4 && std::string(argv[4]) == "eytzinger";
+      writeSearchIndex(argv[3], loadAllowlist(allowlist), eytzinger);
+    } catch (const std::exception& e) {
+      out << e.what() << '\n';
+      return 1;
+    }
+    return 0;
   }
 
-  std::sort(arr.begin(), arr.end());
+  std::string method = argc > 2 ? argv[2] : "binary";
+  In in;
+  try {
+    // the keys come either mapped from an index file or parsed from text
+    std::unique_ptr<SearchIndexFile> index_file;
+    std::vector<int> loaded;
+    const int* arr;
+    size_t n;
+    if (SearchIndexFile::isIndexFile(argv[1])) {
+      index_file.reset(new SearchIndexFile(argv[1]));
+      arr = index_file->keys();
+      n = index_file->size();
+    } else {
+      In allowlist(argv[1]);
+      if (!allowlist.exists()) {
+        out << "failed to open " << argv[1] << '\n';
+        return 1;
+      }
+      loaded = loadAllowlist(allowlist);
+      arr = loaded.data();
+      n = loaded.size();
+    }
 
 #ifdef DEBUG
-  std::cout << "<<< Dumping input arr:\n";
-  if (arr.size() < 30) {
-    for (int x : arr) {
-      std::cout << x << " ";
+    out << "<<< Dumping input arr:\n";
+    if (n < 30) {
+      for (size_t i = 0; i < n; i++) {
+        out << arr[i] << " ";
+      }
+      out << '\n';
     }
-    std::cout << std::endl;
-  }
 #endif
 
-  int key;
-  while (std::cin >> key) {
-    if (bsearch(arr, key) != -1) {
-      std::cout << key << std::endl;
+    if (method == "auto") {
+      method = membership::name(membership::choose(arr, n));
+    }
+
+    if (method == "binary") {
+      filter(in, out, [arr, n](int key) { return bsearch(arr, n, key) != -1; });
+    } else if (method == "eytzinger") {
+      EytzingerIndex index = index_file && index_file->hasEytzinger()
+                             ? index_file->eytzinger()
+                             : EytzingerIndex(arr, n);
+      filter(in, out, [&index](int key) { return index.indexOf(key) != -1; });
+    } else if (method == "batch") {
+      std::vector<int> keys;
+      std::vector<int> found;
+      keys.reserve(kBlockSize);
+      std::exception_ptr error;
+      while (error == nullptr && !in.isEmpty()) {
+        keys.clear();
+        // on a bad token, still answer the keys read before it
+        try {
+          while (keys.size() < kBlockSize && !in.isEmpty()) {
+            keys.push_back(in.readInt());
+          }
+        } catch (...) {
+          error = std::current_exception();
+        }
+        bsearchBatch(arr, n, keys, &found);
+        for (size_t i = 0; i < keys.size(); i++) {
+          if (found[i] != -1) {
+            out << keys[i] << '\n';
+          }
+        }
+      }
+      if (error != nullptr) {
+        std::rethrow_exception(error);
+      }
+    } else if (method == "pipeline") {
+      int threads = argc > 3 ? std::stoi(argv[3]) : defaultThreads();
+      filterPipelined(arr, n, in, out, threads);
+    } else if (method == "learned") {
+      LearnedIndex index(arr, n);
+      filter(in, out, [&index](int key) { return index.indexOf(key) != -1; });
+    } else if (method == "eliasfano") {
+      EliasFano set(arr, n);
+      loaded = std::vector<int>();   // the compressed set replaces the array
+      filter(in, out, [&set](int key) { return set.contains(key); });
+    } else if (method == "bitmap") {
+      BitmapSet set(arr, n);
+      filter(in, out, [&set](int key) { return set.contains(key); });
+    } else if (method == "hash") {
+      FlatHashSet set(arr, n);
+      filter(in, out, [&set](int key) { return set.contains(key); });
+    } else if (method == "bloom") {
+      BloomFilter bloom(arr, n);
+      filter(in, out, [&bloom, arr, n](int key) {
+        return bloom.mayContain(key) && bsearch(arr, n, key) != -1;
+      });
+    } else if (method == "simd") {
+      filter(in, out, [arr, n](int key) { return bsearchSimd(arr, n, key) != -1; });
+    } else {
+      out << "unknown method " << method << '\n';
+      return 1;
     }
+  } catch (const std::exception& e) {
+    out << e.what() << '\n';
+    return 1;
   }
 
-  return 0;
+  return out.exitStatus();
 }
-
@@ -0,0 +1,48 @@
+/******************************************************************************
+ *  Header:       bsearch.h
+ *  Dependencies: opStats.h
+ *
+ *  Classic binary search over a sorted array.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_BSEARCH_H_
+#define FUNDAMENTALS_BSEARCH_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "opStats.h"
+
+// Returns the index of the specified key in the spefified array.
+// @param a the array of the speficed key in the specified array.
+// @param n the number of elements in the array
+// @param key the search key
+// @return index of key in the {array @code a} if present; {@code -1} otherwise
+inline int bsearch(const int* arr, int n, int key) {
+  opstats::Sample sample(opstats::kBsearchNanos);
+  uint64_t probes = 0;
+  int lo = 0;
+  int hi = n - 1;
+  while (lo <= hi) {
+    int mid = lo + (hi - lo) / 2;
+    probes++;
+    // Key is in arr[lo..hi] or not present.
+    if (key < arr[mid]) {
+      hi = mid - 1;
+    } else if (key > arr[mid]) {
+      lo = mid + 1;
+    } else {
+      opstats::record(opstats::kBsearchProbes, probes);
+      return mid;
+    }
+  }
+  opstats::record(opstats::kBsearchProbes, probes);
+  return -1;
+}
+
+inline int bsearch(const std::vector<int>& arr, int key) {
+  return bsearch(arr.data(), arr.size(), key);
+}
+
+#endif // FUNDAMENTALS_BSEARCH_H_
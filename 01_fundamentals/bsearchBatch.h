@@ -0,0 +1,70 @@
+/******************************************************************************
+ *  Header:       bsearchBatch.h
+ *  Dependencies:
+ *
+ *  Binary search of many keys at once, advanced in lockstep with
+ *  software prefetch so the cache misses of independent searches overlap.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_BSEARCH_BATCH_H_
+#define FUNDAMENTALS_BSEARCH_BATCH_H_
+
+#include <cstddef>
+#include <vector>
+
+// Searches for keys[0..count) in the sorted array a[0..n) as one group
+// and stores the index of each key (or -1) in out[0..count).
+//
+// Every search runs the same branchless halving loop, and the length of
+// the range left depends only on n, not on the key. So the group can
+// take each step together: first every search picks its half, then the
+// address of its next probe is exact and is prefetched. By the time the
+// loop comes back to the first search, its line is (ideally) in cache,
+// and a group of G searches pays roughly one memory latency per level
+// instead of G.
+template <size_t G>
+void searchGroup(const int* a, size_t n, const int* keys, size_t count, int* out) {
+  const int* base[G];
+  for (size_t g = 0; g < count; g++) {
+    base[g] = a;
+  }
+  size_t len = n;
+  while (len > 1) {
+    size_t half = len / 2;
+    len -= half;
+    for (size_t g = 0; g < count; g++) {
+      base[g] = base[g][half] < keys[g] ? base[g] + half : base[g];
+      __builtin_prefetch(base[g] + len / 2);
+    }
+  }
+  for (size_t g = 0; g < count; g++) {
+    size_t i = base[g] - a + (base[g][0] < keys[g]);
+    out[g] = i < n && a[i] == keys[g] ? static_cast<int>(i) : -1;
+  }
+}
+
+// Returns in out[i] the index of keys[i] in the sorted array arr if
+// present; -1 otherwise. Same contract as calling bsearch() for every key,
+// but G searches (default 32) are interleaved at a time; see searchGroup.
+template <size_t G = 32>
+void bsearchBatch(const int* arr, size_t n, const std::vector<int>& keys,
+                  std::vector<int>* out) {
+  out->resize(keys.size());
+  if (n == 0) {
+    out->assign(keys.size(), -1);
+    return;
+  }
+  for (size_t i = 0; i < keys.size(); i += G) {
+    size_t count = keys.size() - i < G ? keys.size() - i : G;
+    searchGroup<G>(arr, n, keys.data() + i, count, out->data() + i);
+  }
+}
+
+template <size_t G = 32>
+void bsearchBatch(const std::vector<int>& arr, const std::vector<int>& keys,
+                  std::vector<int>* out) {
+  bsearchBatch<G>(arr.data(), arr.size(), keys, out);
+}
+
+#endif // FUNDAMENTALS_BSEARCH_BATCH_H_
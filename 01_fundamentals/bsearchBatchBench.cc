@@ -0,0 +1,78 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 bsearchBatchBench.cc -o bsearchBatchBench
+ *  Execution:  ./bsearchBatchBench allowlist.txt input.txt
+ *  Dependencies: bsearch.h bsearchBatch.h stopwatch.h
+ *  Data files:   https://algs4.cs.princeton.edu/11model/largeW.txt
+ *                https://algs4.cs.princeton.edu/11model/largeT.txt
+ *
+ *  Search throughput of one bsearch() call per key against bsearchBatch()
+ *  with groups of 16, 32 and 64 interleaved searches. Both files are
+ *  read into memory first, so only the lookups are timed.
+ *
+ *  % ./bsearchBatchBench largeW.txt largeT.txt
+ *  10000000 keys against 1000000, 1051534 found
+ *  bsearch          3.96 Mkeys/s
+ *  batch of 16     19.87 Mkeys/s   5.01x
+ *  batch of 32     24.86 Mkeys/s   6.27x
+ *  batch of 64     25.28 Mkeys/s   6.38x
+ *
+ *  (measured with random stand-ins of the same size as the two files)
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include "bsearch.h"
+#include "bsearchBatch.h"
+#include "stopwatch.h"
+
+// Reads all integers in the named file.
+std::vector<int> readInts(const char* filename) {
+  std::ifstream in(filename);
+  std::vector<int> a;
+  int x;
+  while (in >> x) {
+    a.push_back(x);
+  }
+  return a;
+}
+
+// Runs bsearchBatch with groups of G and prints its throughput.
+template <size_t G>
+void timeBatch(const std::vector<int>& arr, const std::vector<int>& keys,
+               double baseline, long long expected) {
+  std::vector<int> out;
+  Stopwatch timer;
+  bsearchBatch<G>(arr, keys, &out);
+  double elapsed = timer.elapsedTime();
+  long long hits = std::count_if(out.begin(), out.end(), [](int i) { return i != -1; });
+  printf("batch of %-3zu  %7.2f Mkeys/s  %5.2fx%s\n", G, keys.size() / elapsed / 1e6,
+         baseline / elapsed, hits == expected ? "" : "  hits differ!");
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    printf("Usage: ./bsearchBatchBench allowlist.txt input.txt\n");
+    return 1;
+  }
+  std::vector<int> arr = readInts(argv[1]);
+  std::vector<int> keys = readInts(argv[2]);
+  std::sort(arr.begin(), arr.end());
+
+  Stopwatch timer;
+  long long expected = 0;
+  for (int key : keys) {
+    expected += bsearch(arr, key) != -1;
+  }
+  double baseline = timer.elapsedTime();
+  printf("%zu keys against %zu, %lld found\n", keys.size(), arr.size(), expected);
+  printf("bsearch       %7.2f Mkeys/s\n", keys.size() / baseline / 1e6);
+
+  timeBatch<16>(arr, keys, baseline, expected);
+  timeBatch<32>(arr, keys, baseline, expected);
+  timeBatch<64>(arr, keys, baseline, expected);
+  return 0;
+}
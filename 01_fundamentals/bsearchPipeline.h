@@ -0,0 +1,130 @@
+/******************************************************************************
+ *  Header:       bsearchPipeline.h
+ *  Dependencies: boundedQueue.h bsearchBatch.h fastIO.h
+ *
+ *  Multi-threaded allowlist filter: parse, search and write stages
+ *  connected by bounded queues.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_BSEARCH_PIPELINE_H_
+#define FUNDAMENTALS_BSEARCH_PIPELINE_H_
+
+#include <atomic>
+#include <exception>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "boundedQueue.h"
+#include "bsearchBatch.h"
+#include "fastIO.h"
+
+namespace pipeline {
+
+// Number of keys per block handed between stages.
+const size_t kBlockKeys = 1 << 16;
+
+// A block of consecutive input keys and their search results.
+struct Block {
+  long long seq;            // position of the block in the input
+  std::vector<int> keys;
+  std::vector<int> found;   // found[i] = index of keys[i], or -1
+};
+
+} // namespace pipeline
+
+// Reads integers from in and prints to out those present in the sorted
+// array arr[0..n), in input order; the output is byte-identical to the
+// sequential filter. The work is split into three stages:
+//
+//   - the calling thread parses in into blocks of kBlockKeys keys;
+//   - worker threads look up whole blocks with bsearchBatch() against
+//     the shared, read-only array;
+//   - a writer thread puts finished blocks back in input order (by
+//     sequence number) and prints their hits.
+//
+// Blocks come from a fixed pool of 2 * workers + 2 buffers that the writer
+// recycles, and travel through bounded queues, so the parser can run at
+// most that many blocks ahead of the writer and memory stays constant.
+inline void filterPipelined(const int* arr, size_t n, In& in, Out& out, int workers) {
+  using pipeline::Block;
+  if (workers < 1) {
+    workers = 1;
+  }
+  const size_t kBlocks = 2 * workers + 2;
+  std::vector<Block> pool(kBlocks);
+  BoundedQueue<Block*> free_blocks(kBlocks);
+  BoundedQueue<Block*> todo(kBlocks);
+  BoundedQueue<Block*> done(kBlocks);
+  for (Block& b : pool) {
+    b.keys.reserve(pipeline::kBlockKeys);
+    free_blocks.push(&b);
+  }
+
+  std::atomic<int> running(workers);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < workers; t++) {
+    threads.emplace_back([&] {
+      Block* b;
+      while (todo.pop(&b)) {
+        bsearchBatch(arr, n, b->keys, &b->found);
+        done.push(b);
+      }
+      // the last worker out ends the writer's stream
+      if (running.fetch_sub(1) == 1) {
+        done.close();
+      }
+    });
+  }
+  threads.emplace_back([&] {
+    std::map<long long, Block*> pending;
+    long long next = 0;
+    Block* b;
+    while (done.pop(&b)) {
+      pending[b->seq] = b;
+      while (!pending.empty() && pending.begin()->first == next) {
+        b = pending.begin()->second;
+        pending.erase(pending.begin());
+        for (size_t i = 0; i < b->keys.size(); i++) {
+          if (b->found[i] != -1) {
+            out << b->keys[i] << '\n';
+          }
+        }
+        free_blocks.push(b);
+        next++;
+      }
+    }
+  });
+
+  // parse on this thread; on a bad token, pass on the keys before it
+  // and report the error once everything ahead of it has been written
+  std::exception_ptr error;
+  long long seq = 0;
+  Block* b;
+  while (error == nullptr && !in.isEmpty() && free_blocks.pop(&b)) {
+    b->seq = seq++;
+    b->keys.clear();
+    try {
+      while (b->keys.size() < pipeline::kBlockKeys && !in.isEmpty()) {
+        b->keys.push_back(in.readInt());
+      }
+    } catch (...) {
+      error = std::current_exception();
+    }
+    todo.push(b);
+  }
+  todo.close();
+  for (auto& t : threads) {
+    t.join();
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+inline void filterPipelined(const std::vector<int>& arr, In& in, Out& out, int workers) {
+  filterPipelined(arr.data(), arr.size(), in, out, workers);
+}
+
+#endif // FUNDAMENTALS_BSEARCH_PIPELINE_H_
@@ -0,0 +1,86 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread bsearchPipelineBench.cc -o bsearchPipelineBench
+ *  Execution:  ./bsearchPipelineBench allowlist.txt input.txt [max-threads]
+ *  Dependencies: bsearch.h bsearchPipeline.h fastIO.h stopwatch.h
+ *  Data files:   https://algs4.cs.princeton.edu/11model/largeW.txt
+ *                https://algs4.cs.princeton.edu/11model/largeT.txt
+ *
+ *  End-to-end time of the allowlist filter (parse input, search, write
+ *  hits to /dev/null) run sequentially with bsearch() and as a pipeline
+ *  with 1, 2, 4, ... search threads up to max-threads (default: one per
+ *  hardware thread). The allowlist is loaded and sorted once up front.
+ *
+ *  % ./bsearchPipelineBench largeW.txt largeT.txt 4
+ *  sequential   2.786s
+ *  pipeline 1   0.719s   3.87x
+ *  pipeline 2   0.530s   5.25x
+ *  pipeline 4   0.534s   5.21x
+ *
+ *  (single-core machine, random stand-ins for the two files; most of the
+ *  gain at one thread is bsearchBatch(), the parser thread is the
+ *  ceiling once the search threads keep up with it)
+ *
+ ******************************************************************************/
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bsearch.h"
+#include "bsearchPipeline.h"
+#include "fastIO.h"
+#include "stopwatch.h"
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    printf("Usage: ./bsearchPipelineBench allowlist.txt input.txt [max-threads]\n");
+    return 1;
+  }
+  In allowlist(argv[1]);
+  std::vector<int> arr = allowlist.readAllInts();
+  std::sort(arr.begin(), arr.end());
+  int max_threads = argc > 3 ? std::stoi(argv[3]) : std::thread::hardware_concurrency();
+  if (max_threads < 1) {
+    max_threads = 1;
+  }
+  int null = open("/dev/null", O_WRONLY);
+
+  double sequential;
+  {
+    In in(argv[2]);
+    Out out(null);
+    Stopwatch timer;
+    while (!in.isEmpty()) {
+      int key = in.readInt();
+      if (bsearch(arr, key) != -1) {
+        out << key << '\n';
+      }
+    }
+    out.flush();
+    sequential = timer.elapsedTime();
+  }
+  printf("sequential   %.3fs\n", sequential);
+
+  for (int threads = 1; ; threads *= 2) {
+    if (threads > max_threads) {
+      threads = max_threads;
+    }
+    In in(argv[2]);
+    Out out(null);
+    Stopwatch timer;
+    filterPipelined(arr, in, out, threads);
+    out.flush();
+    double elapsed = timer.elapsedTime();
+    printf("pipeline %-3d %.3fs  %5.2fx\n", threads, elapsed, sequential / elapsed);
+    if (threads == max_threads) {
+      break;
+    }
+  }
+  close(null);
+  return 0;
+}
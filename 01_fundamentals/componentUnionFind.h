@@ -0,0 +1,245 @@
+/******************************************************************************
+ *  Header:       componentUnionFind.h
+ *  Dependencies: unionFind.h parallel.h
+ *
+ *  Weighted quick-union that also answers component sizes, iterates
+ *  over the members of a component and exports all components at once.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_COMPONENT_UNION_FIND_H_
+#define FUNDAMENTALS_COMPONENT_UNION_FIND_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+#include "unionFind.h"
+
+ /**
+  * The ComponentUnionFind class template is UnionFind with union by size
+  * (see unionFind.h for the compress and check policies) plus one more
+  * array, next_, that threads the members of every set on a circular
+  * list. A singleton points at itself, and a merge splices the two lists
+  * into one by swapping the next_ entries of the two roots, so lists
+  * cost one swap per merge and nothing per find.
+  *
+  *   - size(p) reads the size of p's root: O(find).
+  *   - forEachMember(p, fn) follows the list from p: O(size(p)).
+  *   - components() exports every set at once as a CSR structure (see
+  *     below) in time linear in n plus the path lengths, spread over
+  *     threads.
+  *
+  * The export does not follow the lists: one giant set would make that a
+  * chain of n dependent cache misses on a single thread. It labels each
+  * element with its root instead, by walks that are independent of one
+  * another (and read-only, so threads can share them), lays the sets out
+  * by their sizes, and scatters the elements into place the way
+  * radixSort does: each thread counts the members of every set in its own
+  * chunk of the elements, a prefix sum over (set, chunk) gives each chunk
+  * a private range within every set, and each thread scatters its chunk.
+  * The counts take count() words per chunk, so the scatter uses at most
+  * n / count() chunks: after a sparse union phase it runs on one thread
+  * rather than take threads * n words.
+  */
+
+template <typename IndexT = uint32_t,
+          typename CompressPolicy = uf::PathHalving,
+          typename CheckPolicy = uf::Checked>
+class ComponentUnionFind {
+  static_assert(std::is_unsigned<IndexT>::value, "IndexT must be an unsigned integer");
+
+ public:
+  typedef IndexT Index;
+  static const bool kNoexcept = !CheckPolicy::kThrows;
+
+  // Initializes an empty union-find data structure with n elements
+  // 0 through n - 1. Initially, each element is in its own set.
+  explicit ComponentUnionFind(size_t n) : parent_(n), next_(n), count_(n) {
+    for (size_t i = 0; i < n; i++) {
+      parent_[i] = static_cast<IndexT>(i);
+      next_[i] = static_cast<IndexT>(i);
+    }
+    link_.init(n);
+  }
+
+  // Returns the number of elements.
+  size_t size() const { return parent_.size(); }
+
+  // Returns the number of elements in the set containing element p.
+  IndexT size(IndexT p) noexcept(kNoexcept) { return link_.size[find(p)]; }
+
+  // Returns the number of sets.
+  IndexT count() const { return count_; }
+
+  // Returns the canonical element of the set containing element p.
+  IndexT find(IndexT p) noexcept(kNoexcept) {
+    CheckPolicy::validate(p, parent_.size());
+    return CompressPolicy::find(parent_.data(), p);
+  }
+
+  // Returns true if p and q are in the same set.
+  bool connected(IndexT p, IndexT q) noexcept(kNoexcept) {
+    return find(p) == find(q);
+  }
+
+  // Merges the set containing element p with the set containing element
+  // q; returns false if they were already the same set.
+  bool merge(IndexT p, IndexT q) noexcept(kNoexcept) {
+    opstats::Sample sample(opstats::kMergeNanos);
+    IndexT root_p = find(p);
+    IndexT root_q = find(q);
+    if (root_p == root_q) {
+      return false;
+    }
+    link_.link(parent_.data(), root_p, root_q);
+    std::swap(next_[root_p], next_[root_q]);
+    count_--;
+    return true;
+  }
+
+  // Returns the height of the tallest tree; see uf::height.
+  size_t height() const {
+    return uf::height(parent_.size(), [this](size_t i) { return parent_[i]; });
+  }
+
+  // Returns the member after p on the circular list of its set.
+  IndexT next(IndexT p) const noexcept(kNoexcept) {
+    CheckPolicy::validate(p, parent_.size());
+    return next_[p];
+  }
+
+  // Calls fn(q) for every member q of the set containing p, starting
+  // with p itself.
+  template <typename Fn>
+  void forEachMember(IndexT p, Fn fn) const {
+    CheckPolicy::validate(p, parent_.size());
+    IndexT q = p;
+    do {
+      fn(q);
+      q = next_[q];
+    } while (q != p);
+  }
+
+  // Exports the sets: on return set c, for c in [0, count()), is
+  // (*members)[(*offsets)[c] .. (*offsets)[c + 1]), in ascending order.
+  // The sets are numbered in the order of their canonical elements, and
+  // (*label)[i], if label is not null, is the number of the set of i.
+  // Changes nothing, and runs on the given number of threads.
+  void components(std::vector<IndexT>* offsets, std::vector<IndexT>* members,
+                  std::vector<IndexT>* label = nullptr,
+                  int threads = defaultThreads()) const {
+    size_t n = parent_.size();
+    std::vector<IndexT> own_label;
+    if (label == nullptr) {
+      label = &own_label;
+    }
+    label->resize(n);
+    offsets->resize(count_ + 1);
+    members->resize(n);
+    IndexT* lab = label->data();
+    IndexT* off = offsets->data();
+    IndexT* mem = members->data();
+    const IndexT* parent = parent_.data();
+    const IndexT* size = link_.size.data();
+    if (threads < 1) {
+      threads = 1;
+    }
+
+    // number the roots, chunk by chunk, and note where each set starts
+    std::vector<IndexT> roots(threads, 0);
+    std::vector<IndexT> elements(threads, 0);
+    parallelChunks(0, n, threads, [&](long long lo, long long hi, int t) {
+      for (long long i = lo; i < hi; i++) {
+        if (parent[i] == static_cast<IndexT>(i)) {
+          roots[t]++;
+          elements[t] += size[i];
+        }
+      }
+    });
+    IndexT first_set = 0;
+    IndexT first_element = 0;
+    for (int t = 0; t < threads; t++) {
+      IndexT r = roots[t];
+      IndexT e = elements[t];
+      roots[t] = first_set;
+      elements[t] = first_element;
+      first_set += r;
+      first_element += e;
+    }
+    off[count_] = static_cast<IndexT>(n);
+    parallelChunks(0, n, threads, [&](long long lo, long long hi, int t) {
+      IndexT c = roots[t];
+      IndexT start = elements[t];
+      for (long long i = lo; i < hi; i++) {
+        if (parent[i] == static_cast<IndexT>(i)) {
+          lab[i] = c;
+          off[c++] = start;
+          start += size[i];
+        }
+      }
+    });
+
+    // label every other element with the set of its root
+    parallelChunks(0, n, threads, [&](long long lo, long long hi, int) {
+      for (long long i = lo; i < hi; i++) {
+        IndexT r = static_cast<IndexT>(i);
+        while (parent[r] != r) {
+          r = parent[r];
+        }
+        if (r != static_cast<IndexT>(i)) {
+          lab[i] = lab[r];
+        }
+      }
+    });
+
+    // the scatter keeps one counter per set per chunk; with many small
+    // sets it runs on fewer chunks, so the counters never take more than
+    // about n words
+    int chunks = threads;
+    if (count_ > 0 && n / count_ < static_cast<size_t>(chunks)) {
+      chunks = std::max<int>(1, static_cast<int>(n / count_));
+    }
+
+    // count the members of each set in each chunk
+    std::vector<IndexT> cursor(static_cast<size_t>(chunks) * count_, 0);
+    parallelChunks(0, n, chunks, [&](long long lo, long long hi, int t) {
+      IndexT* c = &cursor[static_cast<size_t>(t) * count_];
+      for (long long i = lo; i < hi; i++) {
+        c[lab[i]]++;
+      }
+    });
+
+    // turn the counts into starting positions, set-major then chunk, so
+    // each chunk owns a private range of every set
+    parallelFor(0, count_, threads, [&](long long c) {
+      IndexT next = off[c];
+      for (int t = 0; t < chunks; t++) {
+        IndexT k = cursor[static_cast<size_t>(t) * count_ + c];
+        cursor[static_cast<size_t>(t) * count_ + c] = next;
+        next += k;
+      }
+    });
+
+    // scatter: each thread places the elements of its own chunk, so every
+    // set comes out in ascending order
+    parallelChunks(0, n, chunks, [&](long long lo, long long hi, int t) {
+      IndexT* c = &cursor[static_cast<size_t>(t) * count_];
+      for (long long i = lo; i < hi; i++) {
+        mem[c[lab[i]]++] = static_cast<IndexT>(i);
+      }
+    });
+  }
+
+ private:
+  std::vector<IndexT> parent_;                    // parent_[i] = parent of i
+  std::vector<IndexT> next_;                      // next member of i's set
+  uf::BySize::State<IndexT> link_;                // sizes of the roots
+  IndexT count_;                                  // number of components
+}; // class ComponentUnionFind
+
+#endif // FUNDAMENTALS_COMPONENT_UNION_FIND_H_
@@ -0,0 +1,134 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread componentUnionFindBench.cc -o componentUnionFindBench
+ *  Execution:  ./componentUnionFindBench [n [m]]
+ *  Dependencies: componentUnionFind.h unionFind.h parallel.h
+ *                weightedQuickUnionPathCompressionUF.h stopwatch.h
+ *                workloads.h
+ *
+ *  The cost of the member lists on the union phase, and of exporting
+ *  every set as offsets + members afterwards, after m random merges on
+ *  n elements (default: n = m = 50 million):
+ *
+ *    - rescan: find every element, then sort (root, element) pairs;
+ *    - lists: walk the circular member list of every root;
+ *    - components(): label, lay out and scatter, on 1 and on all
+ *      hardware threads.
+ *
+ *  All three exports must agree, set for set and element for element.
+ *
+ *  % ./componentUnionFindBench
+ *  union, size + full                   7.29s
+ *  union, with member lists             8.43s  8093654 components
+ *  export, rescan + sort                7.88s
+ *  export, member lists                 8.70s
+ *  export, components(),  1 thread      1.82s
+ *
+ *  (single-core machine, so no multi-threaded row: the lists cost
+ *  about a sixth more in the union phase, two more misses per merge,
+ *  and walking them is no faster than the rescan because the giant set
+ *  is one long chain of misses; components() exports in under a quarter
+ *  of the union time)
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "componentUnionFind.h"
+#include "parallel.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+#include "workloads.h"
+
+typedef ComponentUnionFind<uint32_t, uf::FullCompression, uf::Unchecked> CUF;
+
+template <typename UF>
+double build(UF& uf, uint64_t n, uint64_t m) {
+  Stopwatch timer;
+  for (uint64_t i = 0; i < m; i++) {
+    uint64_t p = workload::below(workload::mix(0, 2 * i), n);
+    uint64_t q = workload::below(workload::mix(0, 2 * i + 1), n);
+    uf.merge(p, q);
+  }
+  return timer.elapsedTime();
+}
+
+int main(int argc, char* argv[]) {
+  uint64_t n = argc > 1 ? std::stoull(argv[1]) : 50000000;
+  uint64_t m = argc > 2 ? std::stoull(argv[2]) : n;
+
+  double plain;
+  {
+    UnionFind<uint32_t, uf::BySize, uf::FullCompression, uf::Unchecked> uf(n);
+    plain = build(uf, n, m);
+  }
+  CUF uf(n);
+  double lists = build(uf, n, m);
+  printf("%-32s %8.2fs\n", "union, size + full", plain);
+  printf("%-32s %8.2fs  %u components\n", "union, with member lists", lists, uf.count());
+
+  // the rescan numbers the sets by root and sorts each one, as
+  // components() does; the member lists are sorted after the timing
+  std::vector<uint32_t> offsets;
+  std::vector<uint32_t> members;
+  {
+    CUF copy = uf;
+    Stopwatch timer;
+    std::vector<std::pair<uint32_t, uint32_t>> pairs(n);
+    for (uint64_t i = 0; i < n; i++) {
+      pairs[i] = std::make_pair(copy.find(i), static_cast<uint32_t>(i));
+    }
+    std::sort(pairs.begin(), pairs.end());
+    members.resize(n);
+    for (uint64_t i = 0; i < n; i++) {
+      if (i == 0 || pairs[i].first != pairs[i - 1].first) {
+        offsets.push_back(i);
+      }
+      members[i] = pairs[i].second;
+    }
+    offsets.push_back(n);
+    printf("%-32s %8.2fs\n", "export, rescan + sort", timer.elapsedTime());
+  }
+  {
+    Stopwatch timer;
+    std::vector<uint32_t> list_offsets;
+    std::vector<uint32_t> list_members(n);
+    uint32_t k = 0;
+    for (uint64_t r = 0; r < n; r++) {
+      if (uf.find(r) == r) {
+        list_offsets.push_back(k);
+        uf.forEachMember(r, [&](uint32_t q) { list_members[k++] = q; });
+      }
+    }
+    list_offsets.push_back(k);
+    printf("%-32s %8.2fs\n", "export, member lists", timer.elapsedTime());
+    for (size_t c = 0; c + 1 < list_offsets.size(); c++) {
+      std::sort(list_members.begin() + list_offsets[c], list_members.begin() + list_offsets[c + 1]);
+    }
+    if (list_offsets != offsets || list_members != members) {
+      fprintf(stderr, "member lists disagree with the rescan\n");
+      return 1;
+    }
+  }
+  std::vector<int> threads = { 1 };
+  if (defaultThreads() > 1) {
+    threads.push_back(defaultThreads());
+  }
+  for (int t : threads) {
+    std::vector<uint32_t> csr_offsets;
+    std::vector<uint32_t> csr_members;
+    Stopwatch timer;
+    uf.components(&csr_offsets, &csr_members, nullptr, t);
+    double elapsed = timer.elapsedTime();
+    if (csr_offsets != offsets || csr_members != members) {
+      fprintf(stderr, "components() on %d threads disagrees with the rescan\n", t);
+      return 1;
+    }
+    printf("export, components(), %2d thread%s %8.2fs\n", t, t == 1 ? " " : "s", elapsed);
+  }
+  return 0;
+}
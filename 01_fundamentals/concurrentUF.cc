@@ -0,0 +1,90 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread concurrentUF.cc -o concurrentUF
+ *  Execution:  ./concurrentUF [threads] < input.txt
+ *  Dependencies: concurrentUF.h fastIO.h opStats.h
+ *  Data files:   https://algs4.cs.princeton.edu/15uf/tinyUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/mediumUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/largeUF.txt
+ *
+ *  Lock-free union-find shared by several threads.
+ *
+ *  % ./concurrentUF 4 < tinyUF.txt
+ *  2 components
+ *
+ ******************************************************************************/
+
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <thread>
+#include <utility>
+
+#include "concurrentUF.h"
+#include "fastIO.h"
+#include "opStats.h"
+
+// Reads an integer n and a sequence of pairs of integers
+// (between 0 and n - 1) from standard input, where each integer
+// in the pair represents some element; splits the pairs among the
+// given number of threads (default: one per hardware thread) which
+// merge them into one shared data structure, then prints the number
+// of sets. Unlike the sequential drivers the merged pairs are not
+// echoed, since their order depends on the thread schedule.
+int main(int argc, char* argv[]) {
+  opstats::dumpJsonAtExit();
+  In in;
+  Out out;
+  try {
+    int threads = std::thread::hardware_concurrency();
+    if (argc > 1) {
+      threads = std::stoi(argv[1]);
+    }
+    if (threads < 1) {
+      threads = 1;
+    }
+    int n = in.readInt();
+    if (n < 0) {
+      throw std::invalid_argument("number of elements must be non-negative");
+    }
+    ConcurrentUF uf(n);
+
+    std::vector<std::pair<int, int>> pairs;
+    while (!in.isEmpty()) {
+      int p = in.readInt();
+      int q = in.readInt();
+      pairs.emplace_back(p, q);
+    }
+
+    std::vector<std::thread> workers;
+    std::vector<std::exception_ptr> errors(threads);
+    int m = pairs.size();
+    for (int t = 0; t < threads; t++) {
+      int lo = (long long) m * t / threads;
+      int hi = (long long) m * (t + 1) / threads;
+      workers.emplace_back([&, t, lo, hi] {
+        try {
+          for (int i = lo; i < hi; i++) {
+            uf.merge(pairs[i].first, pairs[i].second);
+          }
+        } catch (...) {
+          errors[t] = std::current_exception();
+        }
+      });
+    }
+    for (auto& w : workers) {
+      w.join();
+    }
+    for (auto& e : errors) {
+      if (e) {
+        std::rethrow_exception(e);
+      }
+    }
+    out << uf.count() << " components\n";
+  } catch(const std::exception& e) {
+    out << e.what() << '\n';
+    return 1;
+  }
+
+  return out.exitStatus();
+}
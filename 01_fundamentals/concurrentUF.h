@@ -0,0 +1,174 @@
+/******************************************************************************
+ *  Header:       concurrentUF.h
+ *  Dependencies: unionFind.h
+ *
+ *  Lock-free union-find with CAS-linked roots and path halving.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_CONCURRENT_UF_H_
+#define FUNDAMENTALS_CONCURRENT_UF_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <stdexcept>
+#include <utility>
+
+#include "unionFind.h"
+
+ /**
+  * The ConcurrentUF class represents a union-find data type
+  * (also known as the disjoint-sets data type) that may be shared by
+  * many threads. Any number of threads may call find, merge, connected
+  * and count at the same time without external locking.
+  *
+  * This implementation is the lock-free counterpart of
+  * weightedQuickUnionPathCompressionUF:
+  *
+  *   - merge links one root below the other with a single compare-and-swap
+  *     on the parent slot of the root. If another thread got there first
+  *     the CAS fails and the operation retries from the new roots.
+  *
+  *   - find uses path halving. Each hop tries to point p at its
+  *     grandparent with a CAS; a lost race is harmless because every
+  *     value ever stored in parent_[p] is an ancestor of p.
+  *
+  *   - Instead of union by size (whose size update cannot be made atomic
+  *     with the link) roots are linked by a fixed random priority of
+  *     their index. Every link points from lower to higher priority, so
+  *     no cycle can form under any interleaving, and randomized linking
+  *     keeps the expected tree height logarithmic like weighting does.
+  *
+  * None of the operations ever blocks; a thread only retries when another
+  * thread made progress on the same roots.
+  *
+  * Since a find followed by a merge is no longer atomic, merge reports
+  * whether it actually joined two sets, and connected is the safe
+  * replacement for comparing the results of two finds.
+  *
+  * For additional documentation, see https://algs4.cs.princeton.edu/15uf.
+  */
+
+class ConcurrentUF {
+ public:
+  // Initializes an empty union-find data structure with n elements
+  // 0 through n - 1. Initially, each element is in its own set.
+  ConcurrentUF(int n) : parent_(n), count_(n) {
+    for (int i = 0; i < n; i++) {
+      parent_[i].store(i, std::memory_order_relaxed);
+    }
+  }
+
+  ~ConcurrentUF() { }
+
+  // Returns the number of sets.
+  int count() const { return count_.load(std::memory_order_relaxed); }
+
+  // Returns the canonical element of the set containing element p.
+  // The answer may be stale as soon as it is returned if other threads
+  // are merging concurrently.
+  int find(int p) {
+    validate(p);
+    opstats::Sample sample(opstats::kFindNanos);
+    uint64_t hops = 0;
+    uint64_t writes = 0;
+    while (true) {
+      int parent = parent_[p].load(std::memory_order_acquire);
+      if (parent == p) {
+        opstats::record(opstats::kFindHops, hops);
+        opstats::record(opstats::kFindWrites, writes);
+        return p;
+      }
+      hops++;
+      int grand = parent_[parent].load(std::memory_order_acquire);
+      if (grand != parent) {
+        // path halving, losing this race to another thread is fine
+        writes += parent_[p].compare_exchange_weak(parent, grand,
+                                                   std::memory_order_release,
+                                                   std::memory_order_relaxed);
+      }
+      p = grand;
+    }
+  }
+
+  // Returns true if p and q are in the same set at some point during the call.
+  bool connected(int p, int q) {
+    while (true) {
+      p = find(p);
+      q = find(q);
+      if (p == q) {
+        return true;
+      }
+      // p is still a root, so the two sets were distinct when q was found
+      if (parent_[p].load(std::memory_order_acquire) == p) {
+        return false;
+      }
+    }
+  }
+
+  // Merges the set containing element p with the set containing element q.
+  // Returns true if this call joined two different sets.
+  bool merge(int p, int q) {
+    opstats::Sample sample(opstats::kMergeNanos);
+    while (true) {
+      int root_p = find(p);
+      int root_q = find(q);
+      if (root_p == root_q) {
+        return false;
+      }
+
+      // make the lower priority root point to the higher one
+      if (priority(root_p) > priority(root_q)) {
+        std::swap(root_p, root_q);
+      }
+      int expected = root_p;
+      if (parent_[root_p].compare_exchange_strong(expected, root_q,
+                                                  std::memory_order_acq_rel)) {
+        count_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+      }
+      // root_p got linked by another thread, retry from the new roots
+      p = root_p;
+      q = root_q;
+    }
+  }
+
+  // Returns the height of the tallest tree; see uf::height. Only
+  // meaningful while no other thread is merging.
+  size_t height() const {
+    return uf::height(parent_.size(), [this](size_t i) {
+      return static_cast<size_t>(parent_[i].load(std::memory_order_relaxed));
+    });
+  }
+
+ private:
+  // Returns the random but fixed linking priority of element p.
+  // The mix is a bijection on 32-bit values, so priorities never tie.
+  static uint32_t priority(int p) {
+    uint32_t x = static_cast<uint32_t>(p);
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+  }
+
+  // Validates tha p is a valid index.
+  void validate(int p) const {
+    int n = parent_.size();
+    if (p < 0 || p >= n) {
+      char msg[80];
+      sprintf(msg, "index %d is not between 0 and %d", p, n - 1);
+      throw std::out_of_range(msg);
+    }
+  }
+
+ private:
+  std::vector<std::atomic<int>> parent_;   // parent_[i] = parent of i
+  std::atomic<int> count_;                 // number of components
+}; // class ConcurrentUF
+
+#endif // FUNDAMENTALS_CONCURRENT_UF_H_
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread concurrentUFBench.cc -o concurrentUFBench
+ *  Execution:  ./concurrentUFBench n m [max-threads]
+ *  Dependencies: concurrentUF.h weightedQuickUnionPathCompressionUF.h
+ *                stopwatch.h
+ *
+ *  Thread-scaling benchmark of ConcurrentUF against the sequential
+ *  WeightedQuickUnionPathCompressionUF. Both are fed the same m random
+ *  pairs over n elements; ConcurrentUF is run with 1, 2, 4, ... threads
+ *  up to max-threads (default: one per hardware thread).
+ *
+ *  % ./concurrentUFBench 10000000 20000000 4
+ *  sequential  1.912s   10.46 Mops/s   190504 components
+ *  threads     time     Mops/s   speedup
+ *  1           2.210s    9.05     0.87
+ *  2           2.342s    8.54     0.82
+ *  4           2.289s    8.74     0.84
+ *
+ *  (the run above is from a single-core machine, so it only shows the
+ *  cost of the atomic operations; expect the speedup column to grow with
+ *  the number of physical cores)
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "concurrentUF.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+
+// Returns the time in seconds ConcurrentUF takes to merge all pairs
+// using the given number of threads; stores the resulting set count.
+double timeConcurrent(int n, const std::vector<std::pair<int, int>>& pairs,
+                      int threads, int* count) {
+  ConcurrentUF uf(n);
+  Stopwatch timer;
+  std::vector<std::thread> workers;
+  int m = pairs.size();
+  for (int t = 0; t < threads; t++) {
+    int lo = (long long) m * t / threads;
+    int hi = (long long) m * (t + 1) / threads;
+    workers.emplace_back([&uf, &pairs, lo, hi] {
+      for (int i = lo; i < hi; i++) {
+        uf.merge(pairs[i].first, pairs[i].second);
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  double elapsed = timer.elapsedTime();
+  *count = uf.count();
+  return elapsed;
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    printf("Usage: ./concurrentUFBench n m [max-threads]\n");
+    return 1;
+  }
+  int n = std::stoi(argv[1]);
+  int m = std::stoi(argv[2]);
+  int max_threads = std::thread::hardware_concurrency();
+  if (argc > 3) {
+    max_threads = std::stoi(argv[3]);
+  }
+  if (max_threads < 1) {
+    max_threads = 1;
+  }
+
+  std::mt19937 rng(20201204);
+  std::uniform_int_distribution<int> site(0, n - 1);
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve(m);
+  for (int i = 0; i < m; i++) {
+    pairs.emplace_back(site(rng), site(rng));
+  }
+
+  WeightedQuickUnionPathCompressionUF uf(n);
+  Stopwatch timer;
+  for (const auto& e : pairs) {
+    uf.merge(e.first, e.second);
+  }
+  double sequential = timer.elapsedTime();
+  printf("sequential  %.3fs  %6.2f Mops/s   %d components\n",
+         sequential, m / sequential / 1e6, uf.count());
+
+  printf("threads     time     Mops/s   speedup\n");
+  for (int threads = 1; ; threads *= 2) {
+    if (threads > max_threads) {
+      threads = max_threads;
+    }
+    int count;
+    double elapsed = timeConcurrent(n, pairs, threads, &count);
+    printf("%-10d  %.3fs  %6.2f   %6.2f%s\n",
+           threads, elapsed, m / elapsed / 1e6, sequential / elapsed,
+           count == static_cast<int>(uf.count()) ? "" : "   count mismatch!");
+    if (threads == max_threads) {
+      break;
+    }
+  }
+
+  return 0;
+}
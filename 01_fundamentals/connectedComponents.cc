@@ -0,0 +1,55 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread connectedComponents.cc -o connectedComponents
+ *  Execution:  ./connectedComponents [threads] < input.txt
+ *  Dependencies: connectedComponents.h fastIO.h parallel.h
+ *  Data files:   https://algs4.cs.princeton.edu/15uf/tinyUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/mediumUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/largeUF.txt
+ *
+ *  Offline connected components of a whole edge list at once.
+ *
+ *  % ./connectedComponents < tinyUF.txt
+ *  2 components
+ *
+ ******************************************************************************/
+
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "connectedComponents.h"
+#include "fastIO.h"
+
+// Reads an integer n and a sequence of pairs of integers
+// (between 0 and n - 1) from standard input, where each integer
+// in the pair represents some element; computes the sets of the
+// whole edge list in one bulk call and prints the number of sets.
+int main(int argc, char* argv[]) {
+  In in;
+  Out out;
+  try {
+    int threads = defaultThreads();
+    if (argc > 1) {
+      threads = std::stoi(argv[1]);
+    }
+    int n = in.readInt();
+    if (n < 0) {
+      throw std::invalid_argument("number of elements must be non-negative");
+    }
+    std::vector<std::pair<int, int>> edges;
+    while (!in.isEmpty()) {
+      int p = in.readInt();
+      int q = in.readInt();
+      edges.emplace_back(p, q);
+    }
+
+    Components cc = components(n, edges, threads);
+    out << cc.count << " components\n";
+  } catch(const std::exception& e) {
+    out << e.what() << '\n';
+    return 1;
+  }
+
+  return out.exitStatus();
+}
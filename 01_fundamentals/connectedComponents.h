@@ -0,0 +1,215 @@
+/******************************************************************************
+ *  Header:       connectedComponents.h
+ *  Dependencies: parallel.h
+ *
+ *  Bulk parallel connected components of an edge list (Afforest).
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_CONNECTED_COMPONENTS_H_
+#define FUNDAMENTALS_CONNECTED_COMPONENTS_H_
+
+#include <atomic>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+
+/**
+ * Result of components(): id[i] is the canonical element of the set
+ * containing i and count is the number of sets. Every id[i] is a root
+ * (id[id[i]] == id[i]), so id is a fully compressed parent array that
+ * a weightedQuickUnionPathCompressionUF would accept as its parent_.
+ */
+struct Components {
+  std::vector<int> id;
+  int count;
+};
+
+namespace afforest {
+
+// Hooks the trees of u and v together. Roots are always hooked onto the
+// smaller index with a CAS, so concurrent calls can never form a cycle.
+inline void link(std::vector<std::atomic<int>>& parent, int u, int v) {
+  int p1 = parent[u].load(std::memory_order_relaxed);
+  int p2 = parent[v].load(std::memory_order_relaxed);
+  while (p1 != p2) {
+    int high = p1 > p2 ? p1 : p2;
+    int low = p1 > p2 ? p2 : p1;
+    int p_high = parent[high].load(std::memory_order_relaxed);
+    if (p_high == low) {
+      return;
+    }
+    if (p_high == high &&
+        parent[high].compare_exchange_strong(p_high, low,
+                                             std::memory_order_relaxed)) {
+      return;
+    }
+    p1 = parent[parent[high].load(std::memory_order_relaxed)]
+             .load(std::memory_order_relaxed);
+    p2 = parent[low].load(std::memory_order_relaxed);
+  }
+}
+
+// Requests the parent slots of both endpoints of e ahead of use; the
+// edge list is in arbitrary order, so without this nearly every edge
+// stalls on two cache misses one after the other.
+inline void prefetch(const std::vector<std::atomic<int>>& parent,
+                     const std::pair<int, int>& e) {
+  __builtin_prefetch(&parent[e.first]);
+  __builtin_prefetch(&parent[e.second]);
+}
+
+// Points every element directly at its root.
+inline void compress(std::vector<std::atomic<int>>& parent, int threads) {
+  const long long kPrefetchDistance = 16;
+  parallelChunks(0, parent.size(), threads, [&parent](long long lo, long long hi, int) {
+    for (long long v = lo; v < hi; v++) {
+      if (v + kPrefetchDistance < hi) {
+        __builtin_prefetch(&parent[parent[v + kPrefetchDistance].load(
+            std::memory_order_relaxed)]);
+      }
+      int p = parent[v].load(std::memory_order_relaxed);
+      int pp = parent[p].load(std::memory_order_relaxed);
+      while (p != pp) {
+        parent[v].store(pp, std::memory_order_relaxed);
+        p = pp;
+        pp = parent[p].load(std::memory_order_relaxed);
+      }
+    }
+  });
+}
+
+// Returns the most frequent root among a fixed-size random sample of
+// elements; after the sampling phase this is almost always the root of
+// the largest set.
+inline int sampleFrequentRoot(const std::vector<std::atomic<int>>& parent) {
+  const int kSamples = 1024;
+  std::mt19937 rng(27491095);
+  std::uniform_int_distribution<int> site(0, parent.size() - 1);
+  std::unordered_map<int, int> freq;
+  int best = parent[0].load(std::memory_order_relaxed);
+  int best_count = 0;
+  for (int i = 0; i < kSamples; i++) {
+    int root = parent[site(rng)].load(std::memory_order_relaxed);
+    int c = ++freq[root];
+    if (c > best_count) {
+      best = root;
+      best_count = c;
+    }
+  }
+  return best;
+}
+
+} // namespace afforest
+
+// Returns the connected components of the graph with n elements
+// 0 through n - 1 and the given edges, using the given number of threads.
+//
+// The edge list is processed in two passes, following Afforest
+// (Sutton, Ben-Nun and Bar-Sinai, 2018):
+//
+//   - sampling: a strided sample of about 2n edges is linked and the
+//     forest compressed. On most graphs this already gathers the bulk of
+//     the elements into one large set;
+//   - finish: the remaining edges are linked, except those whose two
+//     endpoints already point at the root of that large set. Those edges
+//     cannot change the answer, and skipping them costs two loads instead
+//     of two finds and a merge.
+//
+// Links are lock-free (see afforest::link) and between passes the
+// forest is flattened, so the per-edge work is a handful of loads, which
+// are prefetched a few edges ahead so their cache misses overlap.
+inline Components components(int n, const std::vector<std::pair<int, int>>& edges,
+                             int threads = defaultThreads()) {
+  const long long kPrefetchDistance = 16;
+  long long m = edges.size();
+  auto invalid = [n](const std::pair<int, int>& e) {
+    return e.first < 0 || e.first >= n || e.second < 0 || e.second >= n;
+  };
+  std::atomic<bool> any_invalid(false);
+  parallelFor(0, m, threads, [&](long long i) {
+    if (invalid(edges[i])) {
+      any_invalid.store(true, std::memory_order_relaxed);
+    }
+  });
+  if (any_invalid.load()) {
+    for (const auto& e : edges) {
+      if (invalid(e)) {
+        char msg[80];
+        sprintf(msg, "edge %d-%d is not between 0 and %d", e.first, e.second, n - 1);
+        throw std::out_of_range(msg);
+      }
+    }
+  }
+
+  Components result;
+  result.count = 0;
+  if (n <= 0) {
+    return result;
+  }
+
+  std::vector<std::atomic<int>> parent(n);
+  parallelFor(0, n, threads, [&parent](long long i) {
+    parent[i].store(i, std::memory_order_relaxed);
+  });
+
+  long long stride = m / (2LL * n) + 1;
+
+  // sampling pass
+  long long samples = (m + stride - 1) / stride;
+  parallelChunks(0, samples, threads, [&](long long lo, long long hi, int) {
+    for (long long i = lo; i < hi; i++) {
+      if (i + kPrefetchDistance < hi) {
+        afforest::prefetch(parent, edges[(i + kPrefetchDistance) * stride]);
+      }
+      const auto& e = edges[i * stride];
+      afforest::link(parent, e.first, e.second);
+    }
+  });
+  afforest::compress(parent, threads);
+
+  // finish pass, skipping edges inside the largest set
+  int c = afforest::sampleFrequentRoot(parent);
+  parallelChunks(0, m, threads, [&](long long lo, long long hi, int) {
+    for (long long i = lo; i < hi; i++) {
+      if (i + kPrefetchDistance < hi) {
+        afforest::prefetch(parent, edges[i + kPrefetchDistance]);
+      }
+      if (i % stride == 0) {
+        continue;
+      }
+      const auto& e = edges[i];
+      if (parent[e.first].load(std::memory_order_relaxed) == c &&
+          parent[e.second].load(std::memory_order_relaxed) == c) {
+        continue;
+      }
+      afforest::link(parent, e.first, e.second);
+    }
+  });
+  afforest::compress(parent, threads);
+
+  result.id.resize(n);
+  std::vector<int> roots(threads > 0 ? threads : 1, 0);
+  parallelChunks(0, n, threads, [&](long long lo, long long hi, int t) {
+    int count = 0;
+    for (long long i = lo; i < hi; i++) {
+      int root = parent[i].load(std::memory_order_relaxed);
+      result.id[i] = root;
+      if (root == i) {
+        count++;
+      }
+    }
+    roots[t] = count;
+  });
+  for (int count : roots) {
+    result.count += count;
+  }
+  return result;
+}
+
+#endif // FUNDAMENTALS_CONNECTED_COMPONENTS_H_
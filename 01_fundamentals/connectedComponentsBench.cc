@@ -0,0 +1,83 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread connectedComponentsBench.cc -o connectedComponentsBench
+ *  Execution:  ./connectedComponentsBench n m [threads]
+ *  Dependencies: connectedComponents.h weightedQuickUnionPathCompressionUF.h
+ *                parallel.h stopwatch.h
+ *
+ *  Compares the bulk components() call against feeding the same m random
+ *  pairs over n elements one by one through
+ *  WeightedQuickUnionPathCompressionUF (find + find + merge, as the
+ *  drivers do), and checks that both produce the same partition.
+ *
+ *  % ./connectedComponentsBench 10000000 100000000 1
+ *  pairwise merge  6.116s    16.35 Medges/s  1 components
+ *  components(1)  4.523s    22.11 Medges/s  1 components
+ *  speedup 1.35x, partitions agree
+ *
+ *  The single-thread gain comes from prefetching and from skipping edges
+ *  inside the giant component; the rest of the gap grows with threads.
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "connectedComponents.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    printf("Usage: ./connectedComponentsBench n m [threads]\n");
+    return 1;
+  }
+  int n = std::stoi(argv[1]);
+  long long m = std::stoll(argv[2]);
+  int threads = defaultThreads();
+  if (argc > 3) {
+    threads = std::stoi(argv[3]);
+  }
+
+  std::mt19937 rng(20201204);
+  std::uniform_int_distribution<int> site(0, n - 1);
+  std::vector<std::pair<int, int>> edges;
+  edges.reserve(m);
+  for (long long i = 0; i < m; i++) {
+    edges.emplace_back(site(rng), site(rng));
+  }
+
+  WeightedQuickUnionPathCompressionUF uf(n);
+  Stopwatch uf_timer;
+  for (const auto& e : edges) {
+    if (uf.find(e.first) != uf.find(e.second)) {
+      uf.merge(e.first, e.second);
+    }
+  }
+  double uf_time = uf_timer.elapsedTime();
+
+  Stopwatch cc_timer;
+  Components cc = components(n, edges, threads);
+  double cc_time = cc_timer.elapsedTime();
+
+  // same partition: every label maps to exactly one union-find root
+  std::vector<int> rep(n, -1);
+  bool same = cc.count == static_cast<int>(uf.count());
+  for (int v = 0; v < n && same; v++) {
+    int root = uf.find(v);
+    if (rep[cc.id[v]] == -1) {
+      rep[cc.id[v]] = root;
+    }
+    same = rep[cc.id[v]] == root;
+  }
+
+  printf("pairwise merge  %.3fs  %7.2f Medges/s  %d components\n",
+         uf_time, m / uf_time / 1e6, uf.count());
+  printf("components(%d)  %.3fs  %7.2f Medges/s  %d components\n",
+         threads, cc_time, m / cc_time / 1e6, cc.count);
+  printf("speedup %.2fx, partitions %s\n", uf_time / cc_time,
+         same ? "agree" : "DIFFER");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,79 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 dynamicConnectivity.cc -o dynamicConnectivity
+ *  Execution:  ./dynamicConnectivity < input.txt
+ *  Dependencies: dynamicConnectivity.h rollbackUnionFind.h unionFind.h
+ *                fastIO.h
+ *
+ *  Offline dynamic connectivity. Reads an integer n and a sequence of
+ *  operations on the elements 0 through n - 1, one per line:
+ *
+ *    + p q     add the edge p-q
+ *    - p q     remove the edge p-q
+ *    ? p q     are p and q connected?
+ *
+ *  and answers every query after reading them all.
+ *
+ *  % cat tinyDC.txt
+ *  6
+ *  + 0 1
+ *  + 1 2
+ *  ? 0 2
+ *  - 1 2
+ *  ? 0 2
+ *  + 2 3
+ *  + 3 0
+ *  ? 0 2
+ *  ? 4 5
+ *
+ *  % ./dynamicConnectivity < tinyDC.txt
+ *  0 2 connected
+ *  0 2 not connected
+ *  0 2 connected
+ *  4 5 not connected
+ *
+ ******************************************************************************/
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "dynamicConnectivity.h"
+#include "fastIO.h"
+
+int main(int argc, char* argv[]) {
+  In in;
+  Out out;
+  try {
+    int n = in.readInt();
+    if (n < 0) {
+      throw std::invalid_argument("number of elements must be non-negative");
+    }
+    std::vector<dynconn::Operation> ops;
+    while (!in.isEmpty()) {
+      std::string op = in.readString();
+      int p = in.readInt();
+      int q = in.readInt();
+      if (op == "+") {
+        ops.push_back({ dynconn::kAdd, p, q });
+      } else if (op == "-") {
+        ops.push_back({ dynconn::kRemove, p, q });
+      } else if (op == "?") {
+        ops.push_back({ dynconn::kQuery, p, q });
+      } else {
+        throw std::invalid_argument("unknown operation " + op);
+      }
+    }
+
+    std::vector<bool> answers = offlineConnectivity(n, ops);
+    size_t next = 0;
+    for (const auto& op : ops) {
+      if (op.type == dynconn::kQuery) {
+        out << op.p << " " << op.q << (answers[next++] ? " connected\n" : " not connected\n");
+      }
+    }
+  } catch (const std::exception& e) {
+    out << e.what() << '\n';
+    return 1;
+  }
+  return out.exitStatus();
+}
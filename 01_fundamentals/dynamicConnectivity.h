@@ -0,0 +1,158 @@
+/******************************************************************************
+ *  Header:       dynamicConnectivity.h
+ *  Dependencies: rollbackUnionFind.h unionFind.h
+ *
+ *  Offline dynamic connectivity: edge insertions, deletions and
+ *  connectivity queries, answered by divide and conquer over time.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_DYNAMIC_CONNECTIVITY_H_
+#define FUNDAMENTALS_DYNAMIC_CONNECTIVITY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rollbackUnionFind.h"
+
+namespace dynconn {
+
+enum OpType {
+  kAdd,       // add the edge p-q
+  kRemove,    // remove one copy of the edge p-q (ignored if there is none)
+  kQuery      // are p and q connected?
+};
+
+struct Operation {
+  OpType type;
+  int p;
+  int q;
+};
+
+// Edges alive over a time interval, hung on the segment tree nodes
+// whose ranges cover it.
+class Solver {
+ public:
+  Solver(int n, const std::vector<Operation>& ops)
+      : ops_(ops), uf_(n), tree_(4 * std::max<size_t>(ops.size(), 1)),
+        queries_before_(ops.size() + 1, 0) {
+    // an edge whose interval covers no query is never merged, so check
+    // every element here rather than leave it to the union-find
+    for (const Operation& op : ops_) {
+      uf::Checked::validate(static_cast<uint32_t>(op.p), n);
+      uf::Checked::validate(static_cast<uint32_t>(op.q), n);
+    }
+    for (size_t t = 0; t < ops_.size(); t++) {
+      queries_before_[t + 1] = queries_before_[t] + (ops_[t].type == kQuery);
+    }
+    collectIntervals();
+  }
+
+  std::vector<bool> solve() {
+    answers_.assign(queries_before_.back(), false);
+    if (!ops_.empty()) {
+      visit(1, 0, ops_.size());
+    }
+    return answers_;
+  }
+
+ private:
+  static uint64_t edgeKey(int p, int q) {
+    if (p > q) {
+      std::swap(p, q);
+    }
+    return static_cast<uint64_t>(static_cast<uint32_t>(p)) << 32 | static_cast<uint32_t>(q);
+  }
+
+  // Turns each add into the interval [add, matching remove) during which
+  // the edge is alive; copies still alive at the end last until then.
+  void collectIntervals() {
+    std::unordered_map<uint64_t, std::vector<size_t>> alive;   // edge -> add times
+    for (size_t t = 0; t < ops_.size(); t++) {
+      const Operation& op = ops_[t];
+      if (op.type == kAdd) {
+        alive[edgeKey(op.p, op.q)].push_back(t);
+      } else if (op.type == kRemove) {
+        auto it = alive.find(edgeKey(op.p, op.q));
+        if (it != alive.end() && !it->second.empty()) {
+          insert(1, 0, ops_.size(), it->second.back(), t, std::make_pair(op.p, op.q));
+          it->second.pop_back();
+        }
+      }
+    }
+    for (const auto& entry : alive) {
+      int p = static_cast<int>(entry.first >> 32);
+      int q = static_cast<int>(entry.first & 0xffffffffu);
+      for (size_t start : entry.second) {
+        insert(1, 0, ops_.size(), start, ops_.size(), std::make_pair(p, q));
+      }
+    }
+  }
+
+  // Hangs edge on the nodes of [lo, hi) that exactly cover [from, to).
+  void insert(size_t node, size_t lo, size_t hi, size_t from, size_t to,
+              std::pair<int, int> edge) {
+    if (to <= lo || hi <= from) {
+      return;
+    }
+    if (from <= lo && hi <= to) {
+      tree_[node].push_back(edge);
+      return;
+    }
+    size_t mid = lo + (hi - lo) / 2;
+    insert(2 * node, lo, mid, from, to, edge);
+    insert(2 * node + 1, mid, hi, from, to, edge);
+  }
+
+  // Merges the edges of node, answers the queries in [lo, hi) below it,
+  // and undoes the merges on the way out.
+  void visit(size_t node, size_t lo, size_t hi) {
+    if (queries_before_[hi] == queries_before_[lo]) {
+      return;
+    }
+    size_t checkpoint = uf_.checkpoint();
+    for (const auto& e : tree_[node]) {
+      uf_.merge(e.first, e.second);
+    }
+    if (hi - lo == 1) {
+      answers_[queries_before_[lo]] = uf_.connected(ops_[lo].p, ops_[lo].q);
+    } else {
+      size_t mid = lo + (hi - lo) / 2;
+      visit(2 * node, lo, mid);
+      visit(2 * node + 1, mid, hi);
+    }
+    uf_.rollback(checkpoint);
+  }
+
+ private:
+  const std::vector<Operation>& ops_;
+  RollbackUnionFind<> uf_;
+  std::vector<std::vector<std::pair<int, int>>> tree_;  // edges per node
+  std::vector<size_t> queries_before_;  // number of queries in ops_[0..t)
+  std::vector<bool> answers_;
+}; // class Solver
+
+} // namespace dynconn
+
+// Answers the kQuery operations of ops, a sequence of edge additions,
+// removals and connectivity queries on the elements 0 through n - 1;
+// returns one answer per query, in order.
+//
+// Every edge is alive over an interval of operation times. The times are
+// the leaves of a segment tree, and each interval is hung on the
+// O(log T) nodes that cover it. A depth-first walk merges the edges of a
+// node on the way in, answers the query at each leaf, and rolls the
+// RollbackUnionFind back on the way out, so every edge is merged and
+// undone once per node it hangs on. Subtrees without queries are skipped.
+//
+// Takes O(T log T log n) time for T operations and O(T log T) memory.
+// Throws std::out_of_range if an element is outside [0, n).
+inline std::vector<bool> offlineConnectivity(int n, const std::vector<dynconn::Operation>& ops) {
+  return dynconn::Solver(n, ops).solve();
+}
+
+#endif // FUNDAMENTALS_DYNAMIC_CONNECTIVITY_H_
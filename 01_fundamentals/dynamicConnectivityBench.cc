@@ -0,0 +1,102 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 dynamicConnectivityBench.cc -o dynamicConnectivityBench
+ *  Execution:  ./dynamicConnectivityBench [n [ops]]
+ *  Dependencies: dynamicConnectivity.h rollbackUnionFind.h unionFind.h
+ *                weightedQuickUnionPathCompressionUF.h stopwatch.h
+ *
+ *  Offline dynamic connectivity with RollbackUnionFind against rebuilding
+ *  a WeightedQuickUnionPathCompressionUF from the live edges for every
+ *  query. The workload is ops random operations on n elements: 40% add a
+ *  random edge, 30% remove a random live edge, 30% query a random pair
+ *  (default: n = 10000, ops = 100000). The rebuild is skipped when it
+ *  would take more than ~10^10 steps.
+ *
+ *  % ./dynamicConnectivityBench
+ *  10000 elements, 100000 operations, 30041 queries
+ *  offline divide and conquer      0.126s
+ *  rebuild per query               2.756s  (speedup 22x)
+ *
+ *  % ./dynamicConnectivityBench 1000000 10000000
+ *  1000000 elements, 10000000 operations, 2998522 queries
+ *  offline divide and conquer     27.085s
+ *  rebuild per query           skipped (~5e+12 steps)
+ *
+ *  (single-core machine)
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dynamicConnectivity.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+
+int main(int argc, char* argv[]) {
+  int n = argc > 1 ? std::stoi(argv[1]) : 10000;
+  size_t m = argc > 2 ? std::stoul(argv[2]) : 100000;
+
+  std::mt19937 rng(n);
+  std::uniform_int_distribution<int> element(0, n - 1);
+  std::vector<dynconn::Operation> ops;
+  std::vector<std::pair<int, int>> live;
+  size_t queries = 0;
+  double rebuild_steps = 0;
+  for (size_t i = 0; i < m; i++) {
+    unsigned kind = rng() % 10;
+    if (kind < 3 && !live.empty()) {
+      size_t j = rng() % live.size();
+      ops.push_back({ dynconn::kRemove, live[j].first, live[j].second });
+      live[j] = live.back();
+      live.pop_back();
+    } else if (kind < 6) {
+      ops.push_back({ dynconn::kQuery, element(rng), element(rng) });
+      queries++;
+      rebuild_steps += n + live.size();
+    } else {
+      live.emplace_back(element(rng), element(rng));
+      ops.push_back({ dynconn::kAdd, live.back().first, live.back().second });
+    }
+  }
+  printf("%d elements, %zu operations, %zu queries\n", n, ops.size(), queries);
+
+  Stopwatch offline_timer;
+  std::vector<bool> answers = offlineConnectivity(n, ops);
+  double offline = offline_timer.elapsedTime();
+  printf("offline divide and conquer  %9.3fs\n", offline);
+
+  if (rebuild_steps > 1e10) {
+    printf("rebuild per query           skipped (~%.0e steps)\n", rebuild_steps);
+    return 0;
+  }
+  Stopwatch rebuild_timer;
+  std::vector<std::pair<int, int>> edges;
+  size_t next = 0;
+  bool agree = true;
+  for (const auto& op : ops) {
+    if (op.type == dynconn::kAdd) {
+      edges.emplace_back(op.p, op.q);
+    } else if (op.type == dynconn::kRemove) {
+      for (size_t j = 0; j < edges.size(); j++) {
+        if (edges[j] == std::make_pair(op.p, op.q)) {
+          edges[j] = edges.back();
+          edges.pop_back();
+          break;
+        }
+      }
+    } else {
+      WeightedQuickUnionPathCompressionUF uf(n);
+      for (const auto& e : edges) {
+        uf.merge(e.first, e.second);
+      }
+      agree = agree && answers[next++] == (uf.find(op.p) == uf.find(op.q));
+    }
+  }
+  double rebuild = rebuild_timer.elapsedTime();
+  printf("rebuild per query           %9.3fs  (speedup %.0fx)%s\n", rebuild,
+         rebuild / offline, agree ? "" : "  ANSWERS DIFFER");
+  return agree ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+/******************************************************************************
+ *  Header:       eliasFano.h
+ *  Dependencies:
+ *
+ *  Compressed sorted set of ints (Elias-Fano encoding) searched in place.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_ELIAS_FANO_H_
+#define FUNDAMENTALS_ELIAS_FANO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The EliasFano class stores a sorted array of n ints drawn from a range
+ * of u values in about 2 + log2(u/n) bits per key, and answers the same
+ * queries as bsearch() without decompressing it.
+ *
+ * Each key, taken relative to the smallest one, is split into its low l
+ * bits, with l = floor(log2(u/n)), and the remaining high bits. The low
+ * bits are packed into an array of n l-bit fields. The high bits go into
+ * a bit vector in unary: key i sets bit high(i) + i, so the keys sharing
+ * a high part h form a run of 1s that is preceded by exactly h 0s. Every
+ * 256th 0 and 1 is sampled, so select (the position of the r-th 0 or 1)
+ * jumps to a sample and scans a few words from there.
+ *
+ * indexOf(key) selects the 0 in front of the run for high(key) and scans
+ * the run, about one key on average, comparing low bits. It touches a
+ * sample, a word or two of the bit vector and one low field: a constant
+ * number of cache lines, where bsearch() touches log n. A run can hold
+ * up to min(n, 2^l) keys when they cluster; past its first few keys the
+ * scan turns into a galloping and binary search by key(), O(log k) for
+ * a run of k keys.
+ *
+ * The constructor takes theta(n + u/2^l) time. For keys spread evenly
+ * over their range, indexOf, contains and key take constant expected
+ * time. Clustered keys make both costlier: the selects scan further
+ * from a sample, and indexOf searches a run of k keys in O(log k)
+ * selects.
+ */
+
+class EliasFano {
+ public:
+  // Builds the set from the array sorted[0..n) in ascending order.
+  EliasFano(const int* sorted, size_t n)
+      : n_(n), min_(0), max_(0), l_(0), low_mask_(0), bits_(0) {
+    if (n_ == 0) {
+      return;
+    }
+    min_ = sorted[0];
+    max_ = sorted[n_ - 1];
+    uint64_t u = static_cast<uint64_t>(static_cast<int64_t>(max_) - min_) + 1;
+    while ((u >> (l_ + 1)) >= n_) {
+      l_++;
+    }
+    low_mask_ = (uint64_t(1) << l_) - 1;
+    low_.assign(n_ * l_ / 64 + 2, 0);
+    bits_ = n_ + ((u - 1) >> l_) + 1;
+    high_.assign(bits_ / 64 + 1, 0);
+    for (size_t i = 0; i < n_; i++) {
+      uint64_t v = static_cast<uint64_t>(static_cast<int64_t>(sorted[i]) - min_);
+      setLow(i, v & low_mask_);
+      size_t pos = (v >> l_) + i;
+      high_[pos / 64] |= uint64_t(1) << (pos % 64);
+    }
+    sample(~uint64_t(0), &zero_samples_);
+    sample(0, &one_samples_);
+  }
+
+  // Builds the set from an array sorted in ascending order.
+  explicit EliasFano(const std::vector<int>& sorted)
+      : EliasFano(sorted.data(), sorted.size()) { }
+
+  // Returns the number of keys.
+  size_t size() const { return n_; }
+
+  // Returns the number of bytes the set occupies.
+  size_t bytes() const {
+    return sizeof(*this) + 8 * (low_.capacity() + high_.capacity() +
+                                zero_samples_.capacity() + one_samples_.capacity());
+  }
+
+  // Returns the i-th smallest key.
+  int key(size_t i) const {
+    uint64_t high = select(one_samples_, 0, i) - i;
+    return static_cast<int>(min_ + static_cast<int64_t>(high << l_ | low(i)));
+  }
+
+  // Returns the index of key in the sorted array the set was built from
+  // if present; -1 otherwise.
+  int indexOf(int key) const {
+    if (n_ == 0 || key < min_ || key > max_) {
+      return -1;
+    }
+    uint64_t v = static_cast<uint64_t>(static_cast<int64_t>(key) - min_);
+    uint64_t h = v >> l_;
+    uint64_t target = v & low_mask_;
+    size_t pos = h == 0 ? 0 : select(zero_samples_, ~uint64_t(0), h - 1) + 1;
+    // the run of keys with high part h; their low parts ascend
+    size_t i = pos - h;
+    for (size_t end = i + kScan; high_[pos / 64] >> (pos % 64) & 1; pos++, i++) {
+      if (i == end) {
+        return searchFrom(i, key);
+      }
+      uint64_t x = low(i);
+      if (x >= target) {
+        return x == target ? static_cast<int>(i) : -1;
+      }
+    }
+    return -1;
+  }
+
+  // Returns true if key is present.
+  bool contains(int key) const { return indexOf(key) != -1; }
+
+ private:
+  static const size_t kSampleRate = 256;
+  // Keys of a run scanned before switching to searchFrom().
+  static const size_t kScan = 8;
+
+  // Returns the position of the r-th (from 0) set bit of w.
+  static int selectInWord(uint64_t w, size_t r) {
+    int shift = 0;
+    for (;;) {
+      size_t c = __builtin_popcountll(w >> shift & 0xff);
+      if (r < c) {
+        break;
+      }
+      r -= c;
+      shift += 8;
+    }
+    uint64_t byte = w >> shift;
+    for (; r > 0; r--) {
+      byte &= byte - 1;
+    }
+    return shift + __builtin_ctzll(byte);
+  }
+
+  // Returns the position of the r-th (from 0) 1 in high_ ^ flip, where
+  // flip is all 0s or all 1s, starting from the sampled positions.
+  size_t select(const std::vector<uint64_t>& samples, uint64_t flip, size_t r) const {
+    size_t pos = samples[r / kSampleRate];
+    r %= kSampleRate;
+    size_t w = pos / 64;
+    uint64_t word = (high_[w] ^ flip) & (~uint64_t(0) << (pos % 64));
+    for (;;) {
+      size_t c = __builtin_popcountll(word);
+      if (r < c) {
+        return w * 64 + selectInWord(word, r);
+      }
+      r -= c;
+      word = high_[++w] ^ flip;
+    }
+  }
+
+  // Returns the index of key among the keys from i on, all of those
+  // before i being smaller, if present; -1 otherwise. Gallops from i,
+  // then binary searches, so a run of k keys sharing a high part, as in
+  // a cluster, costs O(log k) selects rather than k.
+  int searchFrom(size_t i, int key) const {
+    size_t lo = i;
+    size_t hi = i;
+    for (size_t step = 1; hi < n_ && this->key(hi) < key; step *= 2) {
+      lo = hi + 1;
+      hi = lo + step;
+    }
+    if (hi > n_) {
+      hi = n_;
+    }
+    while (lo < hi) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (this->key(mid) < key) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo < n_ && this->key(lo) == key ? static_cast<int>(lo) : -1;
+  }
+
+  // Records the position of every kSampleRate-th 1 in high_ ^ flip.
+  void sample(uint64_t flip, std::vector<uint64_t>* samples) {
+    size_t seen = 0;
+    for (size_t w = 0; w < high_.size(); w++) {
+      uint64_t word = high_[w] ^ flip;
+      if (w == bits_ / 64) {
+        word &= (uint64_t(1) << (bits_ % 64)) - 1;
+      }
+      size_t c = __builtin_popcountll(word);
+      while (samples->size() * kSampleRate < seen + c) {
+        samples->push_back(w * 64 + selectInWord(word, samples->size() * kSampleRate - seen));
+      }
+      seen += c;
+    }
+  }
+
+  uint64_t low(size_t i) const {
+    size_t bit = i * l_;
+    size_t w = bit / 64;
+    int off = bit % 64;
+    // the << 1 keeps the shift below 64 when off is 0
+    return (low_[w] >> off | (low_[w + 1] << 1) << (63 - off)) & low_mask_;
+  }
+
+  void setLow(size_t i, uint64_t x) {
+    size_t bit = i * l_;
+    size_t w = bit / 64;
+    int off = bit % 64;
+    low_[w] |= x << off;
+    if (off + l_ > 64) {
+      low_[w + 1] |= x >> (64 - off);
+    }
+  }
+
+ private:
+  size_t n_;                              // number of keys
+  int min_;                               // smallest key
+  int max_;                               // largest key
+  int l_;                                 // number of low bits per key
+  uint64_t low_mask_;                     // (1 << l_) - 1
+  size_t bits_;                           // length of the high bit vector
+  std::vector<uint64_t> low_;             // n_ packed l_-bit low parts
+  std::vector<uint64_t> high_;            // high parts in unary
+  std::vector<uint64_t> zero_samples_;    // position of every 256th 0 in high_
+  std::vector<uint64_t> one_samples_;     // position of every 256th 1 in high_
+}; // class EliasFano
+
+#endif // FUNDAMENTALS_ELIAS_FANO_H_
@@ -0,0 +1,73 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 eliasFanoBench.cc -o eliasFanoBench
+ *  Execution:  ./eliasFanoBench [n ...]
+ *  Dependencies: bsearch.h eliasFano.h queryBench.h stopwatch.h
+ *
+ *  Space and per-query latency of EliasFano against a sorted vector
+ *  searched with bsearch(), on allowlists of n distinct random keys
+ *  (default: 1M and 100M keys) drawn from a dense range (2n values) and
+ *  a sparse one (10n values). Each is probed with the same 10M random
+ *  queries from its range.
+ *
+ *  % ./eliasFanoBench
+ *             n  range vec B/key      bsearch  EF B/key    eliasfano   speedup
+ *       1000000     2n      4.00     259.7 ns      0.49     131.5 ns     1.97x
+ *       1000000    10n      4.00     262.0 ns      0.77     142.0 ns     1.84x
+ *     100000000     2n      4.00     881.1 ns      0.52     438.1 ns     2.01x
+ *     100000000    10n      4.00     948.0 ns      0.75     446.8 ns     2.12x
+ *
+ *  (single-core machine; distinct keys, so n is slightly below the
+ *  nominal size)
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bsearch.h"
+#include "eliasFano.h"
+#include "queryBench.h"
+
+int main(int argc, char* argv[]) {
+  std::vector<int> sizes = { 1000000, 100000000 };
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; i++) {
+      sizes.push_back(std::stoi(argv[i]));
+    }
+  }
+  const int kQueries = 10000000;
+
+  printf("%12s %6s %9s %12s %9s %12s %9s\n", "n", "range", "vec B/key", "bsearch",
+         "EF B/key", "eliasfano", "speedup");
+  for (int n : sizes) {
+    for (int spread : { 2, 10 }) {
+      std::mt19937 rng(n + spread);
+      std::uniform_int_distribution<int> key(0, spread * n - 1);
+      std::vector<int> arr(n);
+      for (int& x : arr) {
+        x = key(rng);
+      }
+      std::sort(arr.begin(), arr.end());
+      arr.erase(std::unique(arr.begin(), arr.end()), arr.end());
+      std::vector<int> queries(kQueries);
+      for (int& x : queries) {
+        x = key(rng);
+      }
+
+      EliasFano set(arr);
+      long long binary_hits;
+      long long ef_hits;
+      double binary = nsPerQuery(queries, [&arr](int k) { return bsearch(arr, k); },
+                                 &binary_hits);
+      double ef = nsPerQuery(queries, [&set](int k) { return set.indexOf(k); }, &ef_hits);
+      printf("%12d %5dn %9.2f %9.1f ns %9.2f %9.1f ns %8.2fx%s\n", n, spread,
+             4.0, binary, static_cast<double>(set.bytes()) / arr.size(), ef,
+             binary / ef, binary_hits == ef_hits ? "" : "  hits differ!");
+    }
+  }
+  return 0;
+}
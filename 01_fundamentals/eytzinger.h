@@ -0,0 +1,126 @@
+/******************************************************************************
+ *  Header:       eytzinger.h
+ *  Dependencies:
+ *
+ *  Static search index storing a sorted array in Eytzinger (BFS) order.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_EYTZINGER_H_
+#define FUNDAMENTALS_EYTZINGER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The EytzingerIndex class answers the same queries as bsearch() over a
+ * sorted array, but lays the keys out as an implicit binary search tree
+ * in breadth-first order: the children of slot k are slots 2k and 2k + 1.
+ *
+ * The top levels of the tree then share a handful of cache lines that
+ * stay hot across queries, and the 16 descendants four levels below slot
+ * k are the consecutive slots 16k .. 16k + 15, which fill exactly one
+ * 64-byte cache line. The descent prefetches that line and advances with
+ * a branchless k = 2k + (b[k] < key), so the cache misses of successive
+ * levels overlap instead of queueing behind mispredicted branches.
+ *
+ * The constructor takes theta(n) time and 8 bytes per key (the keys plus
+ * their position in the sorted array); indexOf and contains take
+ * theta(log n) time.
+ */
+
+class EytzingerIndex {
+ public:
+  // Builds the index from the array sorted[0..n) in ascending order.
+  EytzingerIndex(const int* sorted, size_t n)
+      : n_(n), storage_(n_ + 1 + kLineInts), rank_storage_(n_ + 1) {
+    // align slot 0 to a cache line so 16k .. 16k + 15 never straddles two
+    uintptr_t addr = reinterpret_cast<uintptr_t>(storage_.data());
+    int* b = storage_.data() + (kLineBytes - addr % kLineBytes) % kLineBytes / sizeof(int);
+    build(sorted, b, 0, 1);
+    b_ = b;
+    rank_ = rank_storage_.data();
+  }
+
+  // Builds the index from an array sorted in ascending order.
+  explicit EytzingerIndex(const std::vector<int>& sorted)
+      : EytzingerIndex(sorted.data(), sorted.size()) { }
+
+  // Initializes a read-only view of a layout built elsewhere (see
+  // layout() and ranks()), for example one mapped from an index file.
+  // b must be 64-byte aligned; nothing is copied, so b and rank must
+  // outlive the view.
+  EytzingerIndex(const int* b, const int* rank, size_t n)
+      : n_(n), b_(b), rank_(rank) { }
+
+  EytzingerIndex(const EytzingerIndex&) = delete;
+  EytzingerIndex& operator=(const EytzingerIndex&) = delete;
+  EytzingerIndex(EytzingerIndex&&) = default;
+
+  ~EytzingerIndex() { }
+
+  // Returns the number of keys.
+  size_t size() const { return n_; }
+
+  // Returns the slots b[0..n]; b[0] is unused.
+  const int* layout() const { return b_; }
+
+  // Returns the sorted positions rank[0..n] of the slots.
+  const int* ranks() const { return rank_; }
+
+  // Returns the index of key in the sorted array the index was built
+  // from if present; -1 otherwise.
+  int indexOf(int key) const {
+    size_t k = lowerBound(key);
+    if (k != 0 && b_[k] == key) {
+      return rank_[k];
+    }
+    return -1;
+  }
+
+  // Returns true if key is present.
+  bool contains(int key) const {
+    size_t k = lowerBound(key);
+    return k != 0 && b_[k] == key;
+  }
+
+ private:
+  static const size_t kLineBytes = 64;
+  static const size_t kLineInts = kLineBytes / sizeof(int);
+
+  // Fills the subtree rooted at slot k of b with sorted[i..] in order;
+  // returns the index of the first key not used.
+  size_t build(const int* sorted, int* b, size_t i, size_t k) {
+    if (k <= n_) {
+      i = build(sorted, b, i, 2 * k);
+      b[k] = sorted[i];
+      rank_storage_[k] = i;
+      i++;
+      i = build(sorted, b, i, 2 * k + 1);
+    }
+    return i;
+  }
+
+  // Returns the slot of the smallest key >= key, or 0 if there is none.
+  size_t lowerBound(int key) const {
+    size_t k = 1;
+    while (k <= n_) {
+      // may point past the end; prefetches never fault
+      __builtin_prefetch(b_ + k * kLineInts);
+      k = 2 * k + (b_[k] < key);
+    }
+    // undo the trailing right turns (the 1 bits) and the last left turn
+    k >>= __builtin_ffsll(~k);
+    return k;
+  }
+
+ private:
+  size_t n_;                        // number of keys
+  std::vector<int> storage_;        // backing store of b_ when owned
+  std::vector<int> rank_storage_;   // backing store of rank_ when owned
+  const int* b_;                    // b_[1..n] = keys in Eytzinger order
+  const int* rank_;                 // rank_[k] = index of b_[k] in the sorted array
+}; // class EytzingerIndex
+
+#endif // FUNDAMENTALS_EYTZINGER_H_
@@ -0,0 +1,63 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 eytzingerBench.cc -o eytzingerBench
+ *  Execution:  ./eytzingerBench [n ...]
+ *  Dependencies: bsearch.h eytzinger.h queryBench.h stopwatch.h
+ *
+ *  Per-query latency of bsearch() and EytzingerIndex::indexOf on sorted
+ *  allowlists of n random keys (default: 1K, 1M and 100M keys). Each size
+ *  is probed with the same 10M random queries, about half of them hits.
+ *
+ *  % ./eytzingerBench
+ *             n      bsearch    eytzinger   speedup
+ *          1000      87.1 ns      35.8 ns     2.43x
+ *       1000000     277.0 ns     159.2 ns     1.74x
+ *     100000000     969.8 ns     407.0 ns     2.38x
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bsearch.h"
+#include "eytzinger.h"
+#include "queryBench.h"
+
+int main(int argc, char* argv[]) {
+  std::vector<int> sizes = { 1000, 1000000, 100000000 };
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; i++) {
+      sizes.push_back(std::stoi(argv[i]));
+    }
+  }
+  const int kQueries = 10000000;
+
+  printf("%12s %12s %12s %9s\n", "n", "bsearch", "eytzinger", "speedup");
+  for (int n : sizes) {
+    std::mt19937 rng(n);
+    std::uniform_int_distribution<int> key(0, 2 * n);
+    std::vector<int> arr(n);
+    for (int& x : arr) {
+      x = key(rng);
+    }
+    std::sort(arr.begin(), arr.end());
+    std::vector<int> queries(kQueries);
+    for (int& x : queries) {
+      x = key(rng);
+    }
+
+    EytzingerIndex index(arr);
+    long long binary_hits;
+    long long eytzinger_hits;
+    double binary = nsPerQuery(queries, [&arr](int k) { return bsearch(arr, k); },
+                               &binary_hits);
+    double eytzinger = nsPerQuery(queries, [&index](int k) { return index.indexOf(k); },
+                                  &eytzinger_hits);
+    printf("%12d %9.1f ns %9.1f ns %8.2fx%s\n", n, binary, eytzinger,
+           binary / eytzinger, binary_hits == eytzinger_hits ? "" : "  hits differ!");
+  }
+  return 0;
+}
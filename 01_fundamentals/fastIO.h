@@ -0,0 +1,409 @@
+/******************************************************************************
+ *  Header:       fastIO.h
+ *  Dependencies: parallel.h
+ *
+ *  Integer input from a memory-mapped file or large stdin chunks, and
+ *  buffered output that only reaches the OS in big writes.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_FAST_IO_H_
+#define FUNDAMENTALS_FAST_IO_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "parallel.h"
+
+/**
+ * The In class reads whitespace-separated integers from a file or from
+ * standard input, in the spirit of algs4's In/StdIn:
+ *
+ *   In in("allowlist.txt");
+ *   while (!in.isEmpty()) {
+ *     int x = in.readInt();
+ *   }
+ *
+ * When the source is a regular file (including stdin redirected with
+ * "< input.txt") it is mapped into memory and parsed in place, with no
+ * copy and no per-token library call. Pipes and terminals are read in
+ * 1 MB chunks instead. Integers are parsed by hand, so there is no
+ * locale, stream state or exception machinery on the hot path.
+ */
+
+class In {
+ public:
+  // Initializes an input stream from standard input.
+  In() : fd_(0), owns_fd_(false) { open(); }
+
+  // Initializes an input stream from the named file.
+  explicit In(const char* filename)
+      : fd_(::open(filename, O_RDONLY)), owns_fd_(true) {
+    if (fd_ >= 0) {
+      open();
+    }
+  }
+
+  // Initializes an input stream over the bytes [begin, end) in memory.
+  In(const char* begin, const char* end)
+      : fd_(-1), owns_fd_(false), eof_(true), cur_(begin), end_(end) { }
+
+  In(const In&) = delete;
+  In& operator=(const In&) = delete;
+
+  ~In() {
+    if (map_ != nullptr) {
+      munmap(map_, map_size_);
+    }
+    if (owns_fd_ && fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  // Returns true if the input source could be opened.
+  bool exists() const { return cur_ != nullptr; }
+
+  // Returns true if there are no more tokens, skipping whitespace.
+  bool isEmpty() {
+    skipWhitespace();
+    return cur_ == end_;
+  }
+
+  // Reads the next token and returns it as an int.
+  int readInt() {
+    skipWhitespace();
+    if (cur_ == end_) {
+      throw std::runtime_error("attempts to read an int, but the input is empty");
+    }
+    bool negative = *cur_ == '-';
+    if (negative || *cur_ == '+') {
+      advance();
+    }
+    int digits = 0;
+    unsigned long long value = 0;
+    while (cur_ != end_ && static_cast<unsigned char>(*cur_ - '0') < 10) {
+      value = value * 10 + (*cur_ - '0');
+      if (value > 2147483648ULL) {
+        throw std::out_of_range("integer out of range");
+      }
+      digits++;
+      advance();
+    }
+    if (digits == 0 || (cur_ != end_ && !isSpace(*cur_))) {
+      throw std::invalid_argument("attempts to read an int, but the next token is not one");
+    }
+    if (!negative && value > 2147483647ULL) {
+      throw std::out_of_range("integer out of range");
+    }
+    return negative ? static_cast<int>(-static_cast<long long>(value))
+                    : static_cast<int>(value);
+  }
+
+  // Reads the next token and returns it as a string.
+  std::string readString() {
+    skipWhitespace();
+    if (cur_ == end_) {
+      throw std::runtime_error("attempts to read a string, but the input is empty");
+    }
+    std::string s;
+    while (cur_ != end_ && !isSpace(*cur_)) {
+      s += *cur_;
+      advance();
+    }
+    return s;
+  }
+
+  // Reads all remaining tokens as ints.
+  std::vector<int> readAllInts() {
+    std::vector<int> a;
+    if (eof_) {
+      // all bytes are in memory and a token takes at least two of them
+      // (digit and separator), so this never reallocates
+      a.reserve((end_ - cur_) / 2 + 1);
+    }
+    while (!isEmpty()) {
+      a.push_back(readInt());
+    }
+    return a;
+  }
+
+  // Reads all remaining tokens as ints, using the given number of threads
+  // when the whole input is in memory: the bytes are cut into one piece
+  // per thread at whitespace, the pieces are parsed in parallel and the
+  // results concatenated.
+  std::vector<int> readAllInts(int threads) {
+    if (!eof_ || threads <= 1) {
+      return readAllInts();
+    }
+    std::vector<const char*> cuts(threads + 1);
+    cuts[0] = cur_;
+    cuts[threads] = end_;
+    for (int t = 1; t < threads; t++) {
+      const char* p = cur_ + (end_ - cur_) * t / threads;
+      if (p < cuts[t - 1]) {
+        p = cuts[t - 1];
+      }
+      while (p != end_ && !isSpace(*p)) {
+        p++;
+      }
+      cuts[t] = p;
+    }
+    cur_ = end_;
+
+    std::vector<std::vector<int>> parts(threads);
+    std::vector<std::exception_ptr> errors(threads);
+    parallelFor(0, threads, threads, [&](long long t) {
+      try {
+        In piece(cuts[t], cuts[t + 1]);
+        parts[t] = piece.readAllInts();
+      } catch (...) {
+        errors[t] = std::current_exception();
+      }
+    });
+    std::vector<size_t> offset(threads + 1, 0);
+    for (int t = 0; t < threads; t++) {
+      if (errors[t] != nullptr) {
+        std::rethrow_exception(errors[t]);
+      }
+      offset[t + 1] = offset[t] + parts[t].size();
+    }
+    std::vector<int> a(offset[threads]);
+    parallelFor(0, threads, threads, [&](long long t) {
+      std::copy(parts[t].begin(), parts[t].end(), a.begin() + offset[t]);
+      std::vector<int>().swap(parts[t]);
+    });
+    return a;
+  }
+
+  // Returns the size in bytes of a memory-mapped source; 0 otherwise.
+  size_t mappedSize() const { return map_ != nullptr ? map_size_ : 0; }
+
+ private:
+  static const size_t kChunk = 1 << 20;
+
+  static bool isSpace(char c) {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+  }
+
+  // Maps a regular file; falls back to chunked reads for anything else.
+  void open() {
+    struct stat st;
+    if (fstat(fd_, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+      off_t offset = lseek(fd_, 0, SEEK_CUR);
+      if (offset < 0) {
+        offset = 0;
+      }
+      void* p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+      if (p != MAP_FAILED) {
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        map_ = static_cast<char*>(p);
+        map_size_ = st.st_size;
+        cur_ = map_ + (offset < st.st_size ? offset : st.st_size);
+        end_ = map_ + map_size_;
+        eof_ = true;
+        return;
+      }
+    }
+    buffer_.resize(kChunk);
+    cur_ = end_ = buffer_.data();
+    refill();
+  }
+
+  // Moves the unread bytes to the front of the buffer and reads more.
+  void refill() {
+    if (eof_) {
+      return;
+    }
+    size_t left = end_ - cur_;
+    memmove(buffer_.data(), cur_, left);
+    ssize_t got = read(fd_, buffer_.data() + left, buffer_.size() - left);
+    cur_ = buffer_.data();
+    end_ = cur_ + left + (got > 0 ? got : 0);
+    if (got <= 0) {
+      eof_ = true;
+    }
+  }
+
+  // Steps past the current byte, reading the next chunk at its end; a
+  // token may straddle two chunks.
+  void advance() {
+    if (++cur_ == end_ && !eof_) {
+      refill();
+    }
+  }
+
+  void skipWhitespace() {
+    while (true) {
+      while (cur_ != end_ && isSpace(*cur_)) {
+        cur_++;
+      }
+      if (cur_ != end_ || eof_) {
+        return;
+      }
+      refill();
+    }
+  }
+
+ private:
+  int fd_;                    // source file descriptor
+  bool owns_fd_;              // close fd_ on destruction
+  bool eof_ = false;          // no more bytes beyond end_
+  char* map_ = nullptr;       // mapped file, if any
+  size_t map_size_ = 0;
+  std::vector<char> buffer_;  // chunk buffer when not mapped
+  const char* cur_ = nullptr; // next unread byte
+  const char* end_ = nullptr; // end of the readable bytes
+}; // class In
+
+/**
+ * The Out class is a buffered writer for standard output (or any file
+ * descriptor). Unlike std::cout << std::endl it never flushes per line:
+ * text accumulates in a 64 KB buffer that is written out when full, on
+ * flush() and on destruction.
+ *
+ *   Out out;
+ *   out << p << " " << q << "\n";
+ *   return out.exitStatus();
+ *
+ * Interrupted writes are retried. Any other write failure (a full disk,
+ * a closed pipe) is remembered and the rest of the output is dropped;
+ * a driver returns exitStatus() so that the failure is reported and
+ * the exit status is not 0.
+ */
+
+class Out {
+ public:
+  // Initializes a writer to the given file descriptor (standard output by default).
+  explicit Out(int fd = 1) : fd_(fd), buffer_(kCapacity), len_(0), error_(0) { }
+
+  Out(const Out&) = delete;
+  Out& operator=(const Out&) = delete;
+
+  ~Out() { flush(); }
+
+  Out& operator<<(char c) {
+    reserve(1);
+    buffer_[len_++] = c;
+    return *this;
+  }
+
+  Out& operator<<(const char* s) {
+    return write(s, strlen(s));
+  }
+
+  Out& operator<<(const std::string& s) {
+    return write(s.data(), s.size());
+  }
+
+  Out& operator<<(int x) { return *this << static_cast<long long>(x); }
+
+  Out& operator<<(long long x) {
+    reserve(24);
+    unsigned long long u = x;
+    if (x < 0) {
+      buffer_[len_++] = '-';
+      u = 0 - u;
+    }
+    // emit two digits per division, right to left
+    static const char kPairs[] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+    char digits[24];
+    char* d = digits + sizeof(digits);
+    while (u >= 100) {
+      const char* pair = kPairs + (u % 100) * 2;
+      u /= 100;
+      *--d = pair[1];
+      *--d = pair[0];
+    }
+    if (u >= 10) {
+      *--d = kPairs[u * 2 + 1];
+      *--d = kPairs[u * 2];
+    } else {
+      *--d = '0' + u;
+    }
+    size_t len = digits + sizeof(digits) - d;
+    memcpy(buffer_.data() + len_, d, len);
+    len_ += len;
+    return *this;
+  }
+
+  Out& write(const char* s, size_t n) {
+    if (n > kCapacity) {
+      flush();
+      writeAll(s, n);
+      return *this;
+    }
+    reserve(n);
+    memcpy(buffer_.data() + len_, s, n);
+    len_ += n;
+    return *this;
+  }
+
+  // Writes out everything buffered so far.
+  void flush() {
+    writeAll(buffer_.data(), len_);
+    len_ = 0;
+  }
+
+  // Flushes and returns true if every write so far succeeded.
+  bool ok() {
+    flush();
+    return error_ == 0;
+  }
+
+  // Flushes and returns the exit status for a driver: 0, or 1 after
+  // reporting on standard error if a write failed.
+  int exitStatus() {
+    if (ok()) {
+      return 0;
+    }
+    fprintf(stderr, "write error: %s\n", strerror(error_));
+    return 1;
+  }
+
+ private:
+  static const size_t kCapacity = 1 << 16;
+
+  void reserve(size_t n) {
+    if (len_ + n > kCapacity) {
+      flush();
+    }
+  }
+
+  void writeAll(const char* s, size_t n) {
+    while (n > 0 && error_ == 0) {
+      ssize_t put = ::write(fd_, s, n);
+      if (put < 0 && errno == EINTR) {
+        continue;
+      }
+      if (put <= 0) {
+        error_ = put < 0 ? errno : EIO;
+        return;
+      }
+      s += put;
+      n -= put;
+    }
+  }
+
+ private:
+  int fd_;                    // destination file descriptor
+  std::vector<char> buffer_;  // pending output
+  size_t len_;                // number of pending bytes
+  int error_;                 // errno of the first failed write, or 0
+}; // class Out
+
+#endif // FUNDAMENTALS_FAST_IO_H_
@@ -0,0 +1,153 @@
+/******************************************************************************
+ *  Header:       flatHashMap.h
+ *  Dependencies: hashing.h
+ *
+ *  Growable open-addressing hash map from 64-bit keys, with SIMD group
+ *  probing.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_FLAT_HASH_MAP_H_
+#define FUNDAMENTALS_FLAT_HASH_MAP_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "hashing.h"
+
+/**
+ * The FlatHashMap class maps uint64_t keys to values of type Value with
+ * the same layout as FlatHashSet: slots in groups of 16, and one control
+ * byte per slot holding kEmpty or 7 bits of the key's hash, so a probe
+ * compares a whole group with one SSE2 instruction and only looks at
+ * the keys whose control byte matches.
+ *
+ * Unlike FlatHashSet it grows: when an insertion would push the load
+ * factor past 7/8 the table doubles and every entry is reinserted, so
+ * insertions take constant amortized time. Entries are never erased.
+ * Growing moves the entries, so pointers returned by find are only good
+ * until the next insertion.
+ *
+ * find and insert take constant expected time; the map takes
+ * 9 + sizeof(Value) bytes per slot, at 7/16 to 7/8 of the slots used.
+ */
+
+template <typename Value>
+class FlatHashMap {
+ public:
+  // Initializes an empty map.
+  FlatHashMap() : size_(0) { resize(kGroupSize); }
+
+  // Returns the number of entries.
+  size_t size() const { return size_; }
+
+  // Returns the number of bytes the map occupies.
+  size_t bytes() const {
+    return sizeof(*this) + ctrl_.capacity() + keys_.capacity() * sizeof(uint64_t) +
+           values_.capacity() * sizeof(Value);
+  }
+
+  // Makes room for n entries without growing.
+  void reserve(size_t n) {
+    size_t slots = ctrl_.size();
+    while (slots * 7 / 8 < n) {
+      slots *= 2;
+    }
+    if (slots != ctrl_.size()) {
+      resize(slots);
+    }
+  }
+
+  // Returns a pointer to the value of key, or nullptr if key is absent.
+  const Value* find(uint64_t key) const {
+    size_t slot = lookup(key, hashing::mix(key));
+    return slot == kNone ? nullptr : &values_[slot];
+  }
+
+  // Inserts key with value if key is absent. Returns a reference to the
+  // value of key either way, and sets *inserted to whether it was new.
+  Value& insert(uint64_t key, const Value& value, bool* inserted) {
+    uint64_t h = hashing::mix(key);
+    size_t slot = lookup(key, h);
+    if (slot != kNone) {
+      *inserted = false;
+      return values_[slot];
+    }
+    if (size_ + 1 > ctrl_.size() * 7 / 8) {
+      resize(2 * ctrl_.size());
+    }
+    slot = emptySlot(h);
+    ctrl_[slot] = h & 0x7f;
+    keys_[slot] = key;
+    values_[slot] = value;
+    size_++;
+    *inserted = true;
+    return values_[slot];
+  }
+
+ private:
+  static const size_t kGroupSize = hashing::kGroupSize;
+  static const size_t kNone = ~size_t(0);
+  static constexpr uint8_t kEmpty = 0x80;
+
+  // Returns the slot holding key, or kNone.
+  size_t lookup(uint64_t key, uint64_t h) const {
+    uint8_t h2 = h & 0x7f;
+    size_t g = (h >> 7) & mask_;
+    for (size_t step = 1; ; step++) {
+      const uint8_t* ctrl = &ctrl_[g * kGroupSize];
+      for (uint32_t m = hashing::match(ctrl, h2); m != 0; m &= m - 1) {
+        size_t slot = g * kGroupSize + __builtin_ctz(m);
+        if (keys_[slot] == key) {
+          return slot;
+        }
+      }
+      if (hashing::match(ctrl, kEmpty) != 0) {
+        return kNone;
+      }
+      g = (g + step) & mask_;
+    }
+  }
+
+  // Returns the first empty slot on the probe sequence of h.
+  size_t emptySlot(uint64_t h) const {
+    size_t g = (h >> 7) & mask_;
+    for (size_t step = 1; ; step++) {
+      uint32_t empty = hashing::match(&ctrl_[g * kGroupSize], kEmpty);
+      if (empty != 0) {
+        return g * kGroupSize + __builtin_ctz(empty);
+      }
+      g = (g + step) & mask_;
+    }
+  }
+
+  // Rebuilds the table with the given number of slots.
+  void resize(size_t slots) {
+    std::vector<uint8_t> ctrl(slots, kEmpty);
+    std::vector<uint64_t> keys(slots);
+    std::vector<Value> values(slots);
+    ctrl.swap(ctrl_);
+    keys.swap(keys_);
+    values.swap(values_);
+    mask_ = slots / kGroupSize - 1;
+    for (size_t i = 0; i < ctrl.size(); i++) {
+      if (ctrl[i] != kEmpty) {
+        uint64_t h = hashing::mix(keys[i]);
+        size_t slot = emptySlot(h);
+        ctrl_[slot] = h & 0x7f;
+        keys_[slot] = keys[i];
+        values_[slot] = values[i];
+      }
+    }
+  }
+
+ private:
+  size_t size_;                 // number of entries
+  size_t mask_;                 // number of groups - 1
+  std::vector<uint8_t> ctrl_;   // h2 of the key in each slot, or kEmpty
+  std::vector<uint64_t> keys_;  // the keys
+  std::vector<Value> values_;   // their values
+}; // class FlatHashMap
+
+#endif // FUNDAMENTALS_FLAT_HASH_MAP_H_
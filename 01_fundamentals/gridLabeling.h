@@ -0,0 +1,316 @@
+/******************************************************************************
+ *  Header:       gridLabeling.h
+ *  Dependencies: unionFind.h parallel.h
+ *
+ *  Connected-component labeling of binary 2D images and 3D volumes,
+ *  by union-find over runs of foreground pixels.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_GRID_LABELING_H_
+#define FUNDAMENTALS_GRID_LABELING_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GRID_LABELING_X86 1
+#endif
+
+#include "parallel.h"
+#include "unionFind.h"
+
+namespace gridlabel {
+
+// Which neighbours connect: the 4 (2D) or 6 (3D) sharing a side, or the
+// 8 (2D) or 26 (3D) sharing at least a corner.
+enum Connectivity { kFaces, kCorners };
+
+// Result of labelGrid(): label[i] is 0 for a background pixel and the
+// component number, from 1 to count, for a foreground one. Components
+// are numbered in the order of their first pixel in memory order.
+struct Labels {
+  std::vector<uint32_t> label;
+  uint32_t count;
+};
+
+// Rows are stored as the edges of their runs, the maximal spans of
+// foreground pixels: run k of a row is [edge[2k], edge[2k + 1]).
+
+// Mask kernels: bit i of the result is set if p[i] is nonzero, for i in
+// [0, 32).
+
+inline uint32_t foregroundScalar(const uint8_t* p) {
+  uint32_t mask = 0;
+  for (int i = 0; i < 32; i++) {
+    mask |= static_cast<uint32_t>(p[i] != 0) << i;
+  }
+  return mask;
+}
+
+#ifdef GRID_LABELING_X86
+__attribute__((target("avx2")))
+inline uint32_t foregroundAvx2(const uint8_t* p) {
+  __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+  __m256i zero = _mm256_cmpeq_epi8(v, _mm256_setzero_si256());
+  return ~static_cast<uint32_t>(_mm256_movemask_epi8(zero));
+}
+#endif
+
+// Slack findRuns() needs past the edges it appends.
+const size_t kEdgeSlack = 8;
+
+// Appends the edges of the runs of row[0..width) to edges and returns
+// the number of runs. Works 32 pixels at a time: the edges are the bits
+// where the mask differs from itself shifted by one pixel, and they are
+// written 8 at a time whatever their number, so that a chunk costs one
+// hard-to-predict branch rather than one per run.
+template <uint32_t (*Foreground)(const uint8_t*)>
+size_t findRuns(const uint8_t* row, size_t width, std::vector<uint32_t>* edges) {
+  size_t first = edges->size();
+  edges->resize(first + width + 1 + kEdgeSlack);
+  uint32_t* out = edges->data() + first;
+  uint32_t carry = 0;  // 1 if the pixel before the chunk is foreground
+  auto chunk = [&](uint32_t x, uint32_t mask) {
+    uint32_t e = mask ^ (mask << 1 | carry);
+    uint32_t* next = out + __builtin_popcount(e);
+    do {
+      for (int k = 0; k < 8; k++) {
+        // past the last edge this writes junk that next overwrites
+        out[k] = x + __builtin_ctz(e | 0x80000000);
+        e &= e - 1;
+      }
+      out += 8;
+    } while (e != 0);
+    out = next;
+    carry = mask >> 31;
+  };
+  size_t x = 0;
+  for (; x + 32 <= width; x += 32) {
+    chunk(static_cast<uint32_t>(x), Foreground(row + x));
+  }
+  if (x < width) {
+    // zero padding: a run reaching the end of the row ends there
+    uint8_t tail[32] = { };
+    memcpy(tail, row + x, width - x);
+    chunk(static_cast<uint32_t>(x), Foreground(tail));
+  } else if (carry != 0) {
+    *out++ = static_cast<uint32_t>(width);
+  }
+  size_t count = out - (edges->data() + first);
+  edges->resize(first + count);
+  return count / 2;
+}
+
+typedef size_t (*FindRunsFn)(const uint8_t*, size_t, std::vector<uint32_t>*);
+
+// Returns the run finder for this CPU: AVX2 when it has it.
+inline FindRunsFn findRunsFor() {
+#ifdef GRID_LABELING_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return findRuns<foregroundAvx2>;
+  }
+#endif
+  return findRuns<foregroundScalar>;
+}
+
+// Union-find over run numbers in which every link hangs the root with
+// the larger number below the other, so that a parent never has a larger
+// number than its child. Paths are halved with uf::PathHalving.
+inline uint32_t unite(uint32_t* parent, uint32_t a, uint32_t b) {
+  a = uf::PathHalving::find(parent, a);
+  b = uf::PathHalving::find(parent, b);
+  if (a < b) {
+    parent[b] = a;
+    return a;
+  }
+  parent[a] = b;
+  return b;
+}
+
+// Unites every pair of overlapping runs from the runs of two neighbouring
+// rows, the m with edges upper, numbered from upper_id, and the n with
+// edges lower, numbered from lower_id; with grow = 1 runs also overlap
+// when they only touch diagonally. Both lists are in order, so one
+// merge-like pass finds all the overlaps.
+inline void uniteRows(uint32_t* parent, const uint32_t* upper, size_t m, uint32_t upper_id,
+                      const uint32_t* lower, size_t n, uint32_t lower_id, uint32_t grow) {
+  size_t i = 0;
+  size_t j = 0;
+  while (i < m && j < n) {
+    uint32_t upper_end = upper[2 * i + 1];
+    uint32_t lower_end = lower[2 * j + 1];
+    if (upper[2 * i] < lower_end + grow && lower[2 * j] < upper_end + grow) {
+      unite(parent, static_cast<uint32_t>(upper_id + i), static_cast<uint32_t>(lower_id + j));
+    }
+    if (upper_end < lower_end) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+}
+
+} // namespace gridlabel
+
+// Labels the connected components of the foreground (nonzero) pixels of
+// a width-by-height-by-depth grid stored in memory order x, then y, then
+// z (depth 1 for a 2D image), running on the given number of threads.
+//
+// Pixels are never united one pair at a time:
+//
+//   - each row is cut into runs of foreground pixels, 32 pixels per step
+//     with AVX2 when the CPU has it (see findRuns);
+//   - runs, not pixels, are the union-find elements, and only runs of
+//     neighbouring rows that overlap are united, in one merge-like pass
+//     per pair of rows;
+//   - the grid is cut into one band of rows (whole slices in 3D) per
+//     thread. Each band finds and unites its runs on its own, touching
+//     only its own part of the forest, and the pairs of rows that straddle
+//     two bands are then stitched together on one thread;
+//   - the runs get their labels in one pass, and the bands write the
+//     label image in parallel.
+//
+// Throws std::length_error if the grid has more pixels than 32-bit
+// labels can number.
+inline gridlabel::Labels labelGrid(const uint8_t* grid, size_t width, size_t height,
+                                   size_t depth = 1,
+                                   gridlabel::Connectivity connectivity = gridlabel::kFaces,
+                                   int threads = defaultThreads()) {
+  static const gridlabel::FindRunsFn find_runs = gridlabel::findRunsFor();
+  const size_t kMaxPixels = std::numeric_limits<uint32_t>::max() - 1;
+  if (width != 0 && height != 0 && depth != 0 && width > kMaxPixels / height / depth) {
+    throw std::length_error("too many pixels for 32-bit labels");
+  }
+  const size_t pixels = width * height * depth;
+  gridlabel::Labels result;
+  result.label.resize(pixels);
+  result.count = 0;
+  const size_t rows = height * depth;
+  if (pixels == 0) {
+    return result;
+  }
+  if (threads < 1) {
+    threads = 1;
+  }
+
+  // bands of whole rows, of whole slices in 3D
+  const size_t unit = depth > 1 ? height : 1;
+  const size_t units = rows / unit;
+  const int bands = static_cast<int>(std::min<size_t>(threads, units));
+  std::vector<size_t> band_row(bands + 1);
+  for (int b = 0; b <= bands; b++) {
+    band_row[b] = units * b / bands * unit;
+  }
+
+  // the earlier rows a row connects to, and whether diagonal contact
+  // counts; a row is identified by (y, z) and the offsets are in rows
+  struct Neighbour {
+    long dy;
+    long dz;
+  };
+  std::vector<Neighbour> neighbours;
+  neighbours.push_back(Neighbour{ -1, 0 });
+  if (depth > 1) {
+    if (connectivity == gridlabel::kCorners) {
+      neighbours.push_back(Neighbour{ -1, -1 });
+      neighbours.push_back(Neighbour{ 1, -1 });
+    }
+    neighbours.push_back(Neighbour{ 0, -1 });
+  }
+  const uint32_t grow = connectivity == gridlabel::kCorners ? 1 : 0;
+
+  // runs of every row, found band by band and then laid end to end;
+  // row r has runs [row_first[r], row_first[r + 1])
+  std::vector<std::vector<uint32_t>> band_edges(bands);
+  std::vector<uint32_t> row_first(rows + 1);
+  parallelFor(0, bands, bands, [&](long long b) {
+    std::vector<uint32_t>& edges = band_edges[b];
+    uint32_t runs = 0;
+    for (size_t r = band_row[b]; r < band_row[b + 1]; r++) {
+      row_first[r] = runs;
+      runs += static_cast<uint32_t>(find_runs(grid + r * width, width, &edges));
+    }
+  });
+  std::vector<uint32_t> band_first(bands + 1, 0);
+  for (int b = 0; b < bands; b++) {
+    band_first[b + 1] = band_first[b] + static_cast<uint32_t>(band_edges[b].size() / 2);
+  }
+  const uint32_t total = band_first[bands];
+  row_first[rows] = total;
+  std::vector<uint32_t> edges(2 * size_t(total));
+  std::vector<uint32_t> parent(total);
+  const uint32_t* all = edges.data();
+  uint32_t* forest = parent.data();
+
+  // unites the overlapping runs of the rows of band b with those of
+  // their neighbour rows: the neighbours inside the band if inner, else
+  // the ones in earlier bands, which only the band's first row (first
+  // slice in 3D) has
+  auto uniteBand = [&](int b, bool inner) {
+    size_t lo = band_row[b];
+    size_t hi = inner ? band_row[b + 1] : std::min(band_row[b + 1], lo + unit);
+    for (size_t r = lo; r < hi; r++) {
+      long y = static_cast<long>(r % height);
+      long z = static_cast<long>(r / height);
+      for (const Neighbour& nb : neighbours) {
+        long ny = y + nb.dy;
+        long nz = z + nb.dz;
+        if (ny < 0 || ny >= static_cast<long>(height) || nz < 0) {
+          continue;
+        }
+        size_t other = static_cast<size_t>(nz) * height + ny;
+        if ((other >= lo) != inner) {
+          continue;
+        }
+        gridlabel::uniteRows(forest, all + 2 * size_t(row_first[other]),
+                             row_first[other + 1] - row_first[other], row_first[other],
+                             all + 2 * size_t(row_first[r]), row_first[r + 1] - row_first[r],
+                             row_first[r], grow);
+      }
+    }
+  };
+  parallelFor(0, bands, bands, [&](long long b) {
+    for (size_t r = band_row[b]; r < band_row[b + 1]; r++) {
+      row_first[r] += band_first[b];
+    }
+    std::copy(band_edges[b].begin(), band_edges[b].end(), edges.begin() + 2 * size_t(band_first[b]));
+    std::vector<uint32_t>().swap(band_edges[b]);
+    for (uint32_t i = band_first[b]; i < band_first[b + 1]; i++) {
+      forest[i] = i;
+    }
+  });
+  parallelFor(0, bands, bands, [&](long long b) { uniteBand(static_cast<int>(b), true); });
+  for (int b = 1; b < bands; b++) {
+    uniteBand(b, false);
+  }
+
+  // number the roots in order; every parent precedes its child, so one
+  // forward pass labels every run with the label of its root
+  std::vector<uint32_t> run_label(total);
+  for (uint32_t i = 0; i < total; i++) {
+    uint32_t p = forest[i];
+    run_label[i] = p == i ? ++result.count : run_label[p];
+  }
+
+  // the label image starts out all background, so only runs are written
+  uint32_t* label = result.label.data();
+  parallelFor(0, bands, bands, [&](long long b) {
+    for (size_t r = band_row[b]; r < band_row[b + 1]; r++) {
+      uint32_t* out = label + r * width;
+      for (uint32_t i = row_first[r]; i < row_first[r + 1]; i++) {
+        std::fill(out + all[2 * size_t(i)], out + all[2 * size_t(i) + 1], run_label[i]);
+      }
+    }
+  });
+  return result;
+}
+
+#endif // FUNDAMENTALS_GRID_LABELING_H_
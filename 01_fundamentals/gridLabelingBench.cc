@@ -0,0 +1,142 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread gridLabelingBench.cc -o gridLabelingBench
+ *  Execution:  ./gridLabelingBench [threads]
+ *  Dependencies: gridLabeling.h weightedQuickUnionPathCompressionUF.h
+ *                unionFind.h parallel.h workloads.h stopwatch.h
+ *
+ *  Megapixels per second labeling the 4-connected (6-connected in 3D)
+ *  components of binary images: one WeightedQuickUnionPathCompressionUF
+ *  site per pixel, merged with its foreground neighbours, against
+ *  labelGrid() on one thread and on the given number of threads
+ *  (default: one per hardware thread). Both must find the same number
+ *  of components.
+ *
+ *  % ./gridLabelingBench
+ *  image                     pixels  components      pixel UF  labelGrid, 1 thread  labelGrid, 1 threads
+ *  noise 50%, 4096^2       16777216     1105602     49.9 MP/s      64.0 MP/s  1.3x      60.8 MP/s  1.2x
+ *  noise 90%, 4096^2       16777216        1562     47.1 MP/s     157.7 MP/s  3.3x     150.3 MP/s  3.2x
+ *  blobs, 4096^2           16777216        1824     83.1 MP/s     314.7 MP/s  3.8x     297.4 MP/s  3.6x
+ *  noise 30%, 256^3        16777216      974813     57.5 MP/s      57.6 MP/s  1.0x      63.7 MP/s  1.1x
+ *
+ *  (single-core machine, so the threads column only shows the cost of
+ *  the fork-join. Runs pay off with their length: on noise they average
+ *  two pixels or less and labelGrid only matches the pixel union-find,
+ *  while on the blobs it unites a few runs per disc and row)
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "gridLabeling.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+#include "workloads.h"
+
+// A width-by-height-by-depth binary grid.
+struct Grid {
+  std::string name;
+  size_t width;
+  size_t height;
+  size_t depth;
+  std::vector<uint8_t> pixels;
+};
+
+// Each pixel foreground with probability p.
+Grid noise(size_t side, size_t depth, double p) {
+  Grid g{ "noise " + std::to_string(static_cast<int>(p * 100)) + "%, " +
+              std::to_string(side) + (depth > 1 ? "^3" : "^2"),
+          side, side, depth, std::vector<uint8_t>(side * side * depth) };
+  uint64_t threshold = static_cast<uint64_t>(p * 18446744073709551615.0);
+  for (size_t i = 0; i < g.pixels.size(); i++) {
+    g.pixels[i] = workload::mix(1, i) < threshold ? 255 : 0;
+  }
+  return g;
+}
+
+// Random discs of radius up to r, covering about half the image: long
+// runs and few components, as in a thresholded photograph.
+Grid blobs(size_t side, size_t r) {
+  Grid g{ "blobs, " + std::to_string(side) + "^2", side, side, 1,
+          std::vector<uint8_t>(side * side) };
+  size_t discs = side * side / (r * r * 2);
+  for (size_t k = 0; k < discs; k++) {
+    long cx = static_cast<long>(workload::below(workload::mix(2, 3 * k), side));
+    long cy = static_cast<long>(workload::below(workload::mix(2, 3 * k + 1), side));
+    long rk = 1 + static_cast<long>(workload::below(workload::mix(2, 3 * k + 2), r));
+    for (long y = std::max(0L, cy - rk); y <= std::min<long>(side - 1, cy + rk); y++) {
+      long dx = static_cast<long>(std::sqrt(static_cast<double>(rk * rk - (y - cy) * (y - cy))));
+      long x0 = std::max(0L, cx - dx);
+      long x1 = std::min<long>(side - 1, cx + dx);
+      std::fill(&g.pixels[y * side + x0], &g.pixels[y * side + x1] + 1, 255);
+    }
+  }
+  return g;
+}
+
+// Counts the components with one union-find site per pixel.
+size_t pixelComponents(const Grid& g) {
+  const size_t w = g.width;
+  const size_t plane = w * g.height;
+  const uint8_t* p = g.pixels.data();
+  WeightedQuickUnionPathCompressionUF uf(g.pixels.size());
+  size_t background = 0;
+  for (size_t i = 0; i < g.pixels.size(); i++) {
+    if (!p[i]) {
+      background++;
+      continue;
+    }
+    if (i % w + 1 < w && p[i + 1]) {
+      uf.merge(i, i + 1);
+    }
+    if (i % plane + w < plane && p[i + w]) {
+      uf.merge(i, i + w);
+    }
+    if (i + plane < g.pixels.size() && p[i + plane]) {
+      uf.merge(i, i + plane);
+    }
+  }
+  return uf.count() - background;
+}
+
+int main(int argc, char* argv[]) {
+  int threads = argc > 1 ? std::stoi(argv[1]) : defaultThreads();
+  printf("%-20s %11s %11s %13s %20s %21s\n", "image", "pixels", "components", "pixel UF",
+         "labelGrid, 1 thread", ("labelGrid, " + std::to_string(threads) + " threads").c_str());
+  std::vector<Grid> grids;
+  grids.push_back(noise(4096, 1, 0.5));
+  grids.push_back(noise(4096, 1, 0.9));
+  grids.push_back(blobs(4096, 40));
+  grids.push_back(noise(256, 256, 0.3));
+  for (const Grid& g : grids) {
+    double mp = g.pixels.size() / 1e6;
+
+    Stopwatch pixel_timer;
+    size_t expected = pixelComponents(g);
+    double pixel = pixel_timer.elapsedTime();
+
+    Stopwatch one_timer;
+    gridlabel::Labels one = labelGrid(g.pixels.data(), g.width, g.height, g.depth,
+                                      gridlabel::kFaces, 1);
+    double grid_one = one_timer.elapsedTime();
+
+    Stopwatch many_timer;
+    gridlabel::Labels many = labelGrid(g.pixels.data(), g.width, g.height, g.depth,
+                                       gridlabel::kFaces, threads);
+    double grid_many = many_timer.elapsedTime();
+
+    if (one.count != expected || many.count != expected) {
+      fprintf(stderr, "%s: %u and %u components, expected %zu\n", g.name.c_str(), one.count,
+              many.count, expected);
+      return 1;
+    }
+    printf("%-20s %11zu %11zu %8.1f MP/s %9.1f MP/s %4.1fx %9.1f MP/s %4.1fx\n",
+           g.name.c_str(), g.pixels.size(), expected, mp / pixel, mp / grid_one,
+           pixel / grid_one, mp / grid_many, pixel / grid_many);
+  }
+  return 0;
+}
@@ -0,0 +1,188 @@
+/******************************************************************************
+ *  Header:       growableUnionFind.h
+ *  Dependencies: flatHashMap.h unionFind.h
+ *
+ *  Union-find over sparse 64-bit keys that grows as new keys arrive.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_GROWABLE_UNION_FIND_H_
+#define FUNDAMENTALS_GROWABLE_UNION_FIND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "flatHashMap.h"
+#include "unionFind.h"
+
+ /**
+  * The GrowableUnionFind class template is a union-find data type whose
+  * elements are arbitrary uint64_t keys rather than 0 through n - 1, and
+  * whose element count is not fixed up front: a key seen for the first
+  * time becomes a new singleton set.
+  *
+  * Each key gets a dense internal slot, in order of arrival, through a
+  * FlatHashMap. The slots form a weighted quick-union with path halving
+  * in the PackedUnionFind layout (a root stores minus the size of its
+  * tree in its parent entry). The parent entries and the key of each
+  * slot live in fixed-size chunks of 2^16 that are allocated as needed
+  * and never move, so growing never copies the forest; only the small
+  * table of chunk pointers is reallocated.
+  *
+  * Once the keys have been mapped, find and merge cost the same as the
+  * fixed-size weighted quick-union plus one hash lookup per key: O(1)
+  * expected for the lookup and O(alpha(n)) amortized for the rest.
+  * The slot variants skip the lookup for callers that keep slots.
+  */
+
+template <typename IndexT = int32_t>
+class GrowableUnionFind {
+  static_assert(std::is_signed<IndexT>::value, "IndexT must be a signed integer");
+
+ public:
+  typedef IndexT Index;
+
+  // Initializes an empty union-find data structure.
+  GrowableUnionFind() : size_(0), count_(0) { }
+
+  // Makes room for n keys in the key map.
+  void reserve(size_t n) { slots_.reserve(n); }
+
+  // Returns the number of keys seen.
+  size_t size() const { return size_; }
+
+  // Returns the number of sets.
+  size_t count() const { return count_; }
+
+  // Returns the number of bytes the structure occupies.
+  size_t bytes() const {
+    return sizeof(*this) + slots_.bytes() +
+           parents_.capacity() * sizeof(parents_[0]) + keys_.capacity() * sizeof(keys_[0]) +
+           parents_.size() * kChunk * (sizeof(IndexT) + sizeof(uint64_t));
+  }
+
+  // Returns true if key has been seen.
+  bool contains(uint64_t key) const { return slots_.find(key) != nullptr; }
+
+  // Returns the slot of key, adding key as a singleton set if it is new.
+  IndexT slotOf(uint64_t key) {
+    if (size_ == static_cast<size_t>(std::numeric_limits<IndexT>::max()) && !contains(key)) {
+      throw std::length_error("too many keys for the index type");
+    }
+    bool inserted;
+    IndexT slot = slots_.insert(key, static_cast<IndexT>(size_), &inserted);
+    if (inserted) {
+      addSlot(key);
+    }
+    return slot;
+  }
+
+  // Returns the key of slot s.
+  uint64_t keyOf(IndexT s) const { return keys_[s >> kChunkBits][s & kChunkMask]; }
+
+  // Returns the canonical key of the set containing key, adding key if
+  // it is new.
+  uint64_t find(uint64_t key) { return keyOf(findSlot(slotOf(key))); }
+
+  // Returns true if p and q are in the same set; keys not seen yet are
+  // only connected to themselves.
+  bool connected(uint64_t p, uint64_t q) {
+    const IndexT* sp = slots_.find(p);
+    const IndexT* sq = slots_.find(q);
+    if (sp == nullptr || sq == nullptr) {
+      return p == q;
+    }
+    IndexT a = *sp;
+    IndexT b = *sq;
+    return findSlot(a) == findSlot(b);
+  }
+
+  // Merges the sets containing keys p and q, adding either if it is new;
+  // returns false if they were already the same set.
+  bool merge(uint64_t p, uint64_t q) {
+    IndexT a = slotOf(p);
+    IndexT b = slotOf(q);
+    return mergeSlots(a, b);
+  }
+
+  // Returns the root slot of the set containing slot s.
+  IndexT findSlot(IndexT s) {
+    opstats::Sample sample(opstats::kFindNanos);
+    uint64_t hops = 0;
+    while (parent(s) >= 0) {
+      IndexT q = parent(s);
+      IndexT g = parent(q);
+      if (g < 0) {
+        opstats::record(opstats::kFindHops, hops + 1);
+        opstats::record(opstats::kFindWrites, hops);
+        return q;
+      }
+      parent(s) = g;
+      s = g;
+      hops++;
+    }
+    opstats::record(opstats::kFindHops, hops);
+    opstats::record(opstats::kFindWrites, hops);
+    return s;
+  }
+
+  // Merges the sets containing slots s and t; returns false if they were
+  // already the same set.
+  bool mergeSlots(IndexT s, IndexT t) {
+    opstats::Sample sample(opstats::kMergeNanos);
+    IndexT a = findSlot(s);
+    IndexT b = findSlot(t);
+    if (a == b) {
+      return false;
+    }
+    // sizes are negated: hang the smaller tree (larger value) below
+    if (parent(a) > parent(b)) {
+      std::swap(a, b);
+    }
+    parent(a) += parent(b);
+    parent(b) = a;
+    count_--;
+    return true;
+  }
+
+  // Returns the height of the tallest tree of slots; see uf::height.
+  size_t height() const {
+    return uf::height(size_, [this](size_t s) {
+      IndexT p = parents_[s >> kChunkBits][s & kChunkMask];
+      return p < 0 ? s : static_cast<size_t>(p);
+    });
+  }
+
+ private:
+  static const int kChunkBits = 16;
+  static const size_t kChunk = size_t(1) << kChunkBits;
+  static const size_t kChunkMask = kChunk - 1;
+
+  IndexT& parent(IndexT s) { return parents_[s >> kChunkBits][s & kChunkMask]; }
+
+  void addSlot(uint64_t key) {
+    if (size_ % kChunk == 0) {
+      parents_.emplace_back(new IndexT[kChunk]);
+      keys_.emplace_back(new uint64_t[kChunk]);
+    }
+    parents_[size_ >> kChunkBits][size_ & kChunkMask] = -1;
+    keys_[size_ >> kChunkBits][size_ & kChunkMask] = key;
+    size_++;
+    count_++;
+  }
+
+ private:
+  FlatHashMap<IndexT> slots_;                           // key -> slot
+  std::vector<std::unique_ptr<IndexT[]>> parents_;      // parent or -size, by chunk
+  std::vector<std::unique_ptr<uint64_t[]>> keys_;       // key of each slot, by chunk
+  size_t size_;                                         // number of slots
+  size_t count_;                                        // number of components
+}; // class GrowableUnionFind
+
+#endif // FUNDAMENTALS_GROWABLE_UNION_FIND_H_
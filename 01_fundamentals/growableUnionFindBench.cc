@@ -0,0 +1,109 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 growableUnionFindBench.cc -o growableUnionFindBench
+ *  Execution:  ./growableUnionFindBench [n [m]]
+ *  Dependencies: growableUnionFind.h flatHashMap.h hashing.h
+ *                weightedQuickUnionPathCompressionUF.h stopwatch.h
+ *                workloads.h
+ *
+ *  Merge throughput of GrowableUnionFind against the fixed-size
+ *  WeightedQuickUnionPathCompressionUF, on m random merges over n
+ *  elements (default: n = m = 10 million). The growable structure is
+ *  fed the same pairs three ways: as dense slots 0 through n - 1 (keys
+ *  added beforehand and not timed, so the row is the chunked forest
+ *  alone), as dense keys, and as keys scattered over the whole 64-bit
+ *  range. The key rows start empty and include growing the key map;
+ *  the "reserved" row sizes it up front.
+ *
+ *  % ./growableUnionFindBench
+ *  structure                             time Mmerge/s    memory
+ *  fixed WQUPC, dense ids               1.09s      9.2     76 MB   1620369 components
+ *  growable, dense slots                1.07s      9.3    322 MB   1620369 components
+ *  growable, dense keys                 4.29s      2.3    322 MB   1620369 components
+ *  growable, sparse keys                5.62s      1.8    322 MB   1620369 components
+ *  growable, sparse keys, reserved      5.81s      1.7    322 MB   1620369 components
+ *
+ *  (single-core machine: on slots the chunked forest keeps pace with
+ *  the fixed array; going through keys costs one hash probe per
+ *  endpoint, a cache miss each once the map outgrows the cache, and
+ *  reserving the map up front saves nothing measurable since doubling
+ *  is amortized)
+ *
+ ******************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "growableUnionFind.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+#include "workloads.h"
+
+// Returns the sparse key standing for the dense id i: a bijection, so
+// distinct ids stay distinct keys.
+inline uint64_t sparse(uint64_t i) {
+  return workload::mix(0, i ^ 0x5bd1e995);
+}
+
+void report(const char* name, double elapsed, uint64_t m, size_t bytes, size_t count) {
+  printf("%-32s %8.2fs %8.1f  %5zu MB   %zu components\n", name, elapsed, m / elapsed / 1e6,
+         bytes >> 20, count);
+}
+
+void runFixed(uint64_t n, uint64_t m) {
+  Stopwatch timer;
+  WeightedQuickUnionPathCompressionUF uf(n);
+  for (uint64_t i = 0; i < m; i++) {
+    uint64_t p = workload::below(workload::mix(0, 2 * i), n);
+    uint64_t q = workload::below(workload::mix(0, 2 * i + 1), n);
+    uf.merge(p, q);
+  }
+  report("fixed WQUPC, dense ids", timer.elapsedTime(), m, 2 * n * sizeof(uint32_t), uf.count());
+}
+
+void runSlots(uint64_t n, uint64_t m) {
+  GrowableUnionFind<> uf;
+  for (uint64_t i = 0; i < n; i++) {
+    uf.slotOf(i);
+  }
+  Stopwatch timer;
+  for (uint64_t i = 0; i < m; i++) {
+    uint64_t p = workload::below(workload::mix(0, 2 * i), n);
+    uint64_t q = workload::below(workload::mix(0, 2 * i + 1), n);
+    uf.mergeSlots(p, q);
+  }
+  report("growable, dense slots", timer.elapsedTime(), m, uf.bytes(), uf.count());
+}
+
+template <typename KeyFn>
+void runKeys(const char* name, uint64_t n, uint64_t m, bool reserve, KeyFn key) {
+  Stopwatch timer;
+  GrowableUnionFind<> uf;
+  if (reserve) {
+    uf.reserve(n);
+  }
+  // the pairs touch only some of the ids; add the rest so that every
+  // run ends with the same elements
+  for (uint64_t i = 0; i < m; i++) {
+    uint64_t p = workload::below(workload::mix(0, 2 * i), n);
+    uint64_t q = workload::below(workload::mix(0, 2 * i + 1), n);
+    uf.merge(key(p), key(q));
+  }
+  for (uint64_t i = 0; i < n; i++) {
+    uf.slotOf(key(i));
+  }
+  report(name, timer.elapsedTime(), m, uf.bytes(), uf.count());
+}
+
+int main(int argc, char* argv[]) {
+  uint64_t n = argc > 1 ? std::stoull(argv[1]) : 10000000;
+  uint64_t m = argc > 2 ? std::stoull(argv[2]) : n;
+
+  printf("%-32s %9s %8s %9s\n", "structure", "time", "Mmerge/s", "memory");
+  runFixed(n, m);
+  runSlots(n, m);
+  runKeys("growable, dense keys", n, m, false, [](uint64_t i) { return i; });
+  runKeys("growable, sparse keys", n, m, false, sparse);
+  runKeys("growable, sparse keys, reserved", n, m, true, sparse);
+  return 0;
+}
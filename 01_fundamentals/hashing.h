@@ -0,0 +1,55 @@
+/******************************************************************************
+ *  Header:       hashing.h
+ *  Dependencies:
+ *
+ *  Hash mixing and control-byte group matching shared by the hash tables
+ *  and the Bloom filter.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_HASHING_H_
+#define FUNDAMENTALS_HASHING_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace hashing {
+
+// Slots per group of a Swiss-table layout: one SSE2 register of control
+// bytes.
+const size_t kGroupSize = 16;
+
+// Mixes the bits of x (the murmur3 finalizer).
+inline uint64_t mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return x;
+}
+
+// Returns the hash of an int key.
+inline uint64_t hash(int key) { return mix(static_cast<uint32_t>(key)); }
+
+// Returns a bit mask of the control bytes in ctrl[0..16) equal to b.
+inline uint32_t match(const uint8_t* ctrl, uint8_t b) {
+#ifdef __SSE2__
+  __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(b)));
+#else
+  uint32_t m = 0;
+  for (size_t i = 0; i < kGroupSize; i++) {
+    m |= static_cast<uint32_t>(ctrl[i] == b) << i;
+  }
+  return m;
+#endif
+}
+
+} // namespace hashing
+
+#endif // FUNDAMENTALS_HASHING_H_
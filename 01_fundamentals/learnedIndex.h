@@ -0,0 +1,197 @@
+/******************************************************************************
+ *  Header:       learnedIndex.h
+ *  Dependencies:
+ *
+ *  Learned index: a piecewise linear model of key -> position over a
+ *  sorted array, with a bounded search around the predicted position.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_LEARNED_INDEX_H_
+#define FUNDAMENTALS_LEARNED_INDEX_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * The LearnedIndex class answers the same queries as bsearch() over a
+ * sorted array by predicting where a key should be instead of bisecting
+ * the whole array.
+ *
+ * The model is a sequence of linear segments, each covering a run of
+ * consecutive keys, with the guarantee that for every key in the run the
+ * predicted position is within epsilon of the true one. The segments are
+ * fitted greedily in one pass (the shrinking cone of FITing-tree and the
+ * PGM-index): a segment starts at a key, keeps the interval of slopes
+ * that still fit every key seen so far, and ends at the first key that
+ * would empty the interval.
+ *
+ * A query finds its segment through a radix table on the top bits of the
+ * key (as in RadixSpline) and a short bisection among the few segments
+ * that share its bucket, evaluates the segment, and searches only the
+ * 2 * epsilon + 1 positions around the prediction. On smooth key sets a
+ * handful of segments model millions of keys, so the model stays in
+ * cache and a query costs a few cache misses in one small window rather
+ * than log2(n) scattered ones.
+ *
+ * The constructor takes theta(n) time; indexOf takes
+ * O(log(segments per bucket) + log(epsilon)) time.
+ */
+
+class LearnedIndex {
+ public:
+  // Builds the index over the array sorted[0..n) in ascending order,
+  // which must outlive the index; epsilon bounds the prediction error.
+  LearnedIndex(const int* sorted, size_t n, size_t epsilon = 32)
+      : a_(sorted), n_(n), epsilon_(epsilon), shift_(0) {
+    if (n_ == 0) {
+      return;
+    }
+    fit();
+    buildRadixTable();
+  }
+
+  // Builds the index over an array sorted in ascending order.
+  explicit LearnedIndex(const std::vector<int>& sorted, size_t epsilon = 32)
+      : LearnedIndex(sorted.data(), sorted.size(), epsilon) { }
+
+  // Returns the number of keys.
+  size_t size() const { return n_; }
+
+  // Returns the number of linear segments in the model.
+  size_t segments() const { return segments_.size(); }
+
+  // Returns the number of bytes the model occupies (not counting the
+  // array it indexes).
+  size_t bytes() const {
+    return sizeof(*this) + segments_.capacity() * sizeof(Segment) +
+           radix_.capacity() * sizeof(uint32_t);
+  }
+
+  // Returns the index of key in the sorted array if present; -1 otherwise.
+  int indexOf(int key) const {
+    if (n_ == 0 || key < a_[0] || key > a_[n_ - 1]) {
+      return -1;
+    }
+    const Segment& s = segments_[segmentFor(key)];
+    double predicted = s.pos + s.slope * (static_cast<int64_t>(key) - s.key);
+    // one extra position either side absorbs floating-point rounding
+    size_t p = predicted < 0 ? 0
+             : predicted >= n_ ? n_ - 1
+             : static_cast<size_t>(predicted);
+    size_t lo = p > epsilon_ + 1 ? p - epsilon_ - 1 : 0;
+    size_t hi = std::min(n_, p + epsilon_ + 2);
+
+    // branchless lower bound in a_[lo..hi)
+    const int* base = a_ + lo;
+    size_t len = hi - lo;
+    while (len > 1) {
+      size_t half = len / 2;
+      base = base[half - 1] < key ? base + half : base;
+      len -= half;
+    }
+    size_t i = base - a_ + (len == 1 && *base < key);
+    return i < n_ && a_[i] == key ? static_cast<int>(i) : -1;
+  }
+
+  // Returns true if key is present.
+  bool contains(int key) const { return indexOf(key) != -1; }
+
+ private:
+  struct Segment {
+    int key;        // first key of the segment
+    size_t pos;     // its position in the array
+    double slope;   // positions per unit of key
+  };
+
+  // Largest number of radix table buckets.
+  static const int kMaxRadixBits = 18;
+
+  // Splits the keys into segments with the shrinking cone algorithm.
+  void fit() {
+    // fit with a slightly tighter bound than queries assume, so rounding
+    // in the slope never pushes a key out of its window
+    double eps = epsilon_ > 1 ? epsilon_ - 1.0 : 0.5;
+    size_t start = 0;
+    double slope_lo = 0;
+    double slope_hi = 1e300;
+    for (size_t i = 1; i <= n_; i++) {
+      bool fits = false;
+      if (i < n_) {
+        double dx = static_cast<double>(static_cast<int64_t>(a_[i]) - a_[start]);
+        double dy = static_cast<double>(i - start);
+        if (dx == 0) {
+          // duplicates of the first key are all predicted at start
+          fits = dy <= eps;
+        } else if ((dy - eps) / dx <= slope_hi && (dy + eps) / dx >= slope_lo) {
+          slope_lo = std::max(slope_lo, (dy - eps) / dx);
+          slope_hi = std::min(slope_hi, (dy + eps) / dx);
+          fits = true;
+        }
+      }
+      if (!fits) {
+        double slope = slope_hi == 1e300 ? 0 : (slope_lo + slope_hi) / 2;
+        segments_.push_back({ a_[start], start, slope });
+        start = i;
+        slope_lo = 0;
+        slope_hi = 1e300;
+      }
+    }
+  }
+
+  // Fills radix_ so that the segments whose first key falls in bucket b
+  // are segments_[radix_[b] .. radix_[b + 1]).
+  void buildRadixTable() {
+    uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(a_[n_ - 1]) - a_[0]);
+    int bits = 1;
+    while (bits < kMaxRadixBits && (size_t(1) << bits) < 2 * segments_.size()) {
+      bits++;
+    }
+    while ((range >> shift_) >= (uint64_t(1) << bits)) {
+      shift_++;
+    }
+    size_t buckets = (range >> shift_) + 1;
+    radix_.assign(buckets + 1, 0);
+    size_t s = 0;
+    for (size_t b = 0; b <= buckets; b++) {
+      while (s < segments_.size() && bucket(segments_[s].key) < b) {
+        s++;
+      }
+      radix_[b] = s;
+    }
+  }
+
+  uint64_t bucket(int key) const {
+    return static_cast<uint64_t>(static_cast<int64_t>(key) - a_[0]) >> shift_;
+  }
+
+  // Returns the last segment whose first key is <= key; requires key >= a_[0].
+  size_t segmentFor(int key) const {
+    uint64_t b = bucket(key);
+    // the answer is the last segment starting in this bucket, or the last
+    // one before it if none does
+    size_t lo = radix_[b] > 0 ? radix_[b] - 1 : 0;
+    size_t hi = radix_[b + 1];
+    while (hi - lo > 1) {
+      size_t mid = lo + (hi - lo) / 2;
+      if (segments_[mid].key <= key) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+ private:
+  const int* a_;                    // the sorted keys
+  size_t n_;                        // number of keys
+  size_t epsilon_;                  // maximum prediction error
+  int shift_;                       // key bits dropped by the radix table
+  std::vector<Segment> segments_;   // the model, by first key
+  std::vector<uint32_t> radix_;     // first segment of each bucket
+}; // class LearnedIndex
+
+#endif // FUNDAMENTALS_LEARNED_INDEX_H_
@@ -0,0 +1,93 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 mappedUF.cc -o mappedUF
+ *  Execution:  ./mappedUF state.uf < input.txt
+ *  Dependencies: mappedUnionFind.h unionFind.h searchIndex.h fastIO.h
+ *                opStats.h
+ *  Data files:   https://algs4.cs.princeton.edu/15uf/tinyUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/mediumUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/largeUF.txt
+ *
+ *  The dynamic-connectivity client on a MappedUnionFind kept in the
+ *  named file. The first run creates it; later runs resume from it, so
+ *  feeding the same input again merges nothing new. A snapshot is
+ *  forked every million pairs, and the state is saved at the end.
+ *
+ *  % ./mappedUF tiny.uf < tinyUF.txt
+ *  4 3
+ *  3 8
+ *  6 5
+ *  9 4
+ *  2 1
+ *  5 0
+ *  7 2
+ *  6 1
+ *  2 components
+ *
+ *  % ./mappedUF tiny.uf < tinyUF.txt
+ *  2 components
+ *
+ ******************************************************************************/
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "fastIO.h"
+#include "mappedUnionFind.h"
+#include "opStats.h"
+
+typedef MappedUnionFind<uint32_t, uf::Checked> UF;
+
+// Reads an integer n and a sequence of pairs of integers
+// (between 0 and n - 1 from standard input, where each integer)
+// in the pair represents some element;
+// if the elements are in different sets, merge the two sets
+// and print the pair to standard output.
+int main(int argc, char* argv[]) {
+  opstats::dumpJsonAtExit();
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s state.uf < input.txt\n", argv[0]);
+    return 1;
+  }
+  const char* filename = argv[1];
+  const long kSnapshotEvery = 1000000;
+  In in;
+  Out out;
+  try {
+    int n = in.readInt();
+    if (n < 0) {
+      throw std::invalid_argument("number of elements must be non-negative");
+    }
+    std::unique_ptr<UF> uf;
+    if (access(filename, F_OK) == 0) {
+      uf.reset(new UF(filename));
+      if (uf->size() != static_cast<size_t>(n)) {
+        throw std::runtime_error(std::string(filename) + " holds " +
+                                 std::to_string(uf->size()) + " elements, not " +
+                                 std::to_string(n));
+      }
+    } else {
+      uf.reset(new UF(filename, n));
+    }
+    for (long pairs = 1; !in.isEmpty(); pairs++) {
+      int p = in.readInt();
+      int q = in.readInt();
+      if (uf->merge(p, q)) {
+        out << p << " " << q << '\n';
+      }
+      if (pairs % kSnapshotEvery == 0) {
+        uf->snapshot();
+      }
+    }
+    uf->save();
+    out << static_cast<long long>(uf->count()) << " components\n";
+  } catch(const std::exception& e) {
+    out << e.what() << '\n';
+    return 1;
+  }
+  return out.exitStatus();
+}
@@ -0,0 +1,440 @@
+/******************************************************************************
+ *  Header:       mappedUnionFind.h
+ *  Dependencies: unionFind.h searchIndex.h
+ *
+ *  Weighted quick-union with path compression whose arrays live in a
+ *  memory-mapped file, with crash-safe snapshots and instant reopen.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_MAPPED_UNION_FIND_H_
+#define FUNDAMENTALS_MAPPED_UNION_FIND_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "searchIndex.h"
+#include "unionFind.h"
+
+/**
+ * A union-find file holds the parent and size arrays of a weighted
+ * quick-union, in native byte order:
+ *
+ *   offset 0    mappeduf::Header (64 bytes)
+ *   offset 64   parent[0..n)
+ *   (aligned)   size[0..n)
+ *
+ * Both arrays start on a 64-byte boundary and are zero-padded to one.
+ * The header carries the element and set counts, the number of
+ * snapshots taken so far, a checksum of itself and a checksum of
+ * everything after it (see searchindex::Checksum).
+ */
+
+namespace mappeduf {
+
+const char kMagic[8] = { 'A', 'L', 'G', 'S', '4', 'U', 'F', '\0' };
+const uint32_t kVersion = 1;
+
+struct Header {
+  char magic[8];              // kMagic
+  uint32_t version;           // kVersion
+  uint32_t index_bytes;       // sizeof(IndexT)
+  uint64_t n;                 // number of elements
+  uint64_t count;             // number of sets
+  uint64_t generation;        // number of snapshots saved, 0 when created
+  uint64_t size_offset;       // byte offset of the size array
+  uint64_t payload_checksum;  // checksum of all bytes after the header
+  uint64_t header_checksum;   // checksum of the 56 bytes above
+};
+static_assert(sizeof(Header) == 64, "union-find header must be one cache line");
+
+inline uint64_t headerChecksum(const Header& h) {
+  searchindex::Checksum c;
+  c.update(&h, offsetof(Header, header_checksum));
+  return c.value();
+}
+
+// Writes data[0..n) to fd; returns false on failure.
+inline bool writeAll(int fd, const void* data, size_t n) {
+  const char* p = static_cast<const char*>(data);
+  while (n > 0) {
+    ssize_t written = write(fd, p, std::min<size_t>(n, size_t(1) << 30));
+    if (written <= 0) {
+      return false;
+    }
+    p += written;
+    n -= written;
+  }
+  return true;
+}
+
+} // namespace mappeduf
+
+ /**
+  * The MappedUnionFind class template is WeightedQuickUnionPathCompressionUF
+  * (union by size, full path compression) on arrays mapped from a file,
+  * so that hours of merges survive the process.
+  *
+  * The file is mapped copy-on-write (MAP_PRIVATE): reopening it reads
+  * and checks the 64-byte header and nothing else, so find and merge
+  * resume at once, for any n, and the arrays are paged in from the page
+  * cache as they are touched. Changes stay in this process until
+  * snapshot() saves them, so the file always holds the state as of the
+  * last snapshot and never a half-written one:
+  *
+  *   - snapshot() forks; the child, which sees the arrays frozen at the
+  *     moment of the fork, writes them to a temporary file, fsyncs it
+  *     and renames it over the original, while the parent carries on
+  *     after only the cost of the fork. waitSnapshot() waits for it.
+  *   - save() does the same in the calling process.
+  *
+  * A crash at any point leaves either the previous or the new snapshot
+  * on disk, each with valid checksums. While a snapshot is written, each
+  * page the parent modifies is copied once by the kernel, and until this
+  * object is destroyed the replaced file keeps its disk space. Forking
+  * is only safe while no other thread is running.
+  *
+  * find and merge take the same time as in WeightedQuickUnionPathCompressionUF
+  * once the pages are resident: O(log n) worst case, O(alpha(n))
+  * amortized. Opening takes constant time; creating a file and saving
+  * take theta(n) time.
+  */
+
+template <typename IndexT = uint32_t, typename CheckPolicy = uf::Checked>
+class MappedUnionFind {
+  static_assert(std::is_unsigned<IndexT>::value, "IndexT must be an unsigned integer");
+
+ public:
+  typedef IndexT Index;
+  static const bool kNoexcept = !CheckPolicy::kThrows;
+
+  // Creates the named file with n elements 0 through n - 1, each in its
+  // own set, and maps it. Throws std::length_error if n does not fit in
+  // IndexT, before anything is written, and std::runtime_error on I/O
+  // failure.
+  MappedUnionFind(const char* filename, size_t n)
+      : map_(nullptr), length_(0), parent_(nullptr), size_(nullptr), n_(n), count_(n),
+        generation_(0), child_(-1) {
+    if (n > std::numeric_limits<IndexT>::max()) {
+      throw std::length_error("too many elements for the index type");
+    }
+    names(filename);
+    if (!writeInitial()) {
+      throw std::runtime_error(std::string("failed to write ") + filename);
+    }
+    map(filename);
+  }
+
+  // Maps the named file as it was last saved. Throws std::runtime_error
+  // if it cannot be opened or is not a valid union-find file.
+  explicit MappedUnionFind(const char* filename)
+      : map_(nullptr), length_(0), parent_(nullptr), size_(nullptr), n_(0), count_(0),
+        generation_(0), child_(-1) {
+    names(filename);
+    map(filename);
+  }
+
+  MappedUnionFind(const MappedUnionFind&) = delete;
+  MappedUnionFind& operator=(const MappedUnionFind&) = delete;
+
+  // Waits for a snapshot in progress and unmaps the file; changes made
+  // since the last snapshot are lost.
+  ~MappedUnionFind() {
+    waitSnapshot();
+    munmap(map_, length_);
+  }
+
+  // Returns the number of elements.
+  size_t size() const { return n_; }
+
+  // Returns the number of sets.
+  IndexT count() const { return count_; }
+
+  // Returns the number of snapshots saved to the file so far, counting
+  // the one in progress.
+  uint64_t generation() const { return generation_; }
+
+  // Returns the canonical element of the set containing element p.
+  IndexT find(IndexT p) noexcept(kNoexcept) {
+    CheckPolicy::validate(p, n_);
+    return uf::FullCompression::find(parent_, p);
+  }
+
+  // Returns true if p and q are in the same set.
+  bool connected(IndexT p, IndexT q) noexcept(kNoexcept) {
+    return find(p) == find(q);
+  }
+
+  // Merges the set containing element p with the set containing element
+  // q; returns false if they were already the same set.
+  bool merge(IndexT p, IndexT q) noexcept(kNoexcept) {
+    opstats::Sample sample(opstats::kMergeNanos);
+    IndexT a = find(p);
+    IndexT b = find(q);
+    if (a == b) {
+      return false;
+    }
+    // ties keep the first root, as uf::BySize does
+    if (size_[a] < size_[b]) {
+      std::swap(a, b);
+    }
+    parent_[b] = a;
+    size_[a] += size_[b];
+    count_--;
+    return true;
+  }
+
+  // Returns the height of the tallest tree; see uf::height.
+  size_t height() const {
+    return uf::height(n_, [this](size_t i) { return parent_[i]; });
+  }
+
+  // Starts saving the current state to the file in a child process and
+  // returns; waits first for the previous snapshot, if any. Throws
+  // std::runtime_error if the process cannot fork.
+  void snapshot() {
+    waitSnapshot();
+    generation_++;
+    // the child writes through a buffer allocated here, not on its stack
+    std::vector<IndexT> block(kBlock);
+    pid_t pid = fork();
+    if (pid < 0) {
+      generation_--;
+      throw std::runtime_error("failed to fork a snapshot of " + filename_);
+    }
+    if (pid == 0) {
+      _exit(writeSnapshot(block.data()) ? 0 : 1);
+    }
+    child_ = pid;
+  }
+
+  // Waits for the snapshot in progress, if any. Returns false if it
+  // failed, in which case the file still holds the snapshot before.
+  bool waitSnapshot() {
+    if (child_ < 0) {
+      return true;
+    }
+    int status;
+    pid_t pid;
+    do {
+      pid = waitpid(child_, &status, 0);
+    } while (pid < 0 && errno == EINTR);
+    child_ = -1;
+    bool ok = pid > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+    if (!ok) {
+      generation_--;
+    }
+    return ok;
+  }
+
+  // Saves the current state to the file and returns when it is on disk.
+  // Throws std::runtime_error on I/O failure.
+  void save() {
+    if (!waitSnapshot()) {
+      throw std::runtime_error("failed to save " + filename_);
+    }
+    generation_++;
+    std::vector<IndexT> block(kBlock);
+    if (!writeSnapshot(block.data())) {
+      generation_--;
+      throw std::runtime_error("failed to save " + filename_);
+    }
+  }
+
+  // Returns true if the arrays in the file match its payload checksum.
+  // Reads the whole file.
+  bool verify() const {
+    searchindex::Checksum c;
+    c.update(map_ + sizeof(mappeduf::Header), fileLength(n_) - sizeof(mappeduf::Header));
+    return c.value() == header().payload_checksum;
+  }
+
+ private:
+  // Elements written per block when saving.
+  static constexpr size_t kBlock = 1 << 16;
+
+  static uint64_t sizeOffset(uint64_t n) {
+    return searchindex::alignUp(sizeof(mappeduf::Header) + n * sizeof(IndexT));
+  }
+
+  static uint64_t fileLength(uint64_t n) {
+    return searchindex::alignUp(sizeOffset(n) + n * sizeof(IndexT));
+  }
+
+  const mappeduf::Header& header() const {
+    return *reinterpret_cast<const mappeduf::Header*>(map_);
+  }
+
+  // Precomputes every name the snapshot child needs, so that it does not
+  // allocate memory.
+  void names(const char* filename) {
+    filename_ = filename;
+    tmp_ = filename_ + ".tmp";
+    size_t slash = filename_.rfind('/');
+    dir_ = slash == std::string::npos ? "." : filename_.substr(0, slash + 1);
+  }
+
+  mappeduf::Header makeHeader(uint64_t payload_checksum) const {
+    mappeduf::Header h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, mappeduf::kMagic, sizeof(mappeduf::kMagic));
+    h.version = mappeduf::kVersion;
+    h.index_bytes = sizeof(IndexT);
+    h.n = n_;
+    h.count = count_;
+    h.generation = generation_;
+    h.size_offset = sizeOffset(n_);
+    h.payload_checksum = payload_checksum;
+    h.header_checksum = mappeduf::headerChecksum(h);
+    return h;
+  }
+
+  // Writes the arrays produced by fill, in blocks of kBlock elements
+  // through block, to the temporary file and renames it over the file,
+  // syncing both. fill(array, from, to, block) copies array[from..to)
+  // (0 for parent, 1 for size) to block.
+  template <typename Fill>
+  bool writeFile(Fill fill, IndexT* block) const {
+    static const char zeros[searchindex::kAlign] = { 0 };
+    int fd = open(tmp_.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      return false;
+    }
+    searchindex::Checksum payload;
+    bool ok = lseek(fd, sizeof(mappeduf::Header), SEEK_SET) >= 0;
+    for (int array = 0; ok && array < 2; array++) {
+      for (size_t from = 0; ok && from < n_; from += kBlock) {
+        size_t to = std::min(n_, from + kBlock);
+        fill(array, from, to, block);
+        payload.update(block, (to - from) * sizeof(IndexT));
+        ok = mappeduf::writeAll(fd, block, (to - from) * sizeof(IndexT));
+      }
+      size_t pad = (array == 0 ? sizeOffset(n_) : fileLength(n_)) -
+                   (array == 0 ? sizeof(mappeduf::Header) : sizeOffset(n_)) -
+                   n_ * sizeof(IndexT);
+      payload.update(zeros, pad);
+      ok = ok && mappeduf::writeAll(fd, zeros, pad);
+    }
+    mappeduf::Header h = makeHeader(payload.value());
+    ok = ok && pwrite(fd, &h, sizeof(h), 0) == static_cast<ssize_t>(sizeof(h)) &&
+         fsync(fd) == 0;
+    ok = close(fd) == 0 && ok;
+    if (!ok || rename(tmp_.c_str(), filename_.c_str()) != 0) {
+      unlink(tmp_.c_str());
+      return false;
+    }
+    // make the rename itself durable
+    int dir = open(dir_.c_str(), O_RDONLY);
+    if (dir >= 0) {
+      fsync(dir);
+      close(dir);
+    }
+    return true;
+  }
+
+  // Writes n singleton sets.
+  bool writeInitial() const {
+    std::vector<IndexT> block(kBlock);
+    return writeFile([](int array, size_t from, size_t to, IndexT* block) {
+      for (size_t i = from; i < to; i++) {
+        block[i - from] = array == 0 ? static_cast<IndexT>(i) : 1;
+      }
+    }, block.data());
+  }
+
+  // Writes the current arrays through block, of kBlock elements.
+  bool writeSnapshot(IndexT* block) const {
+    const IndexT* parent = parent_;
+    const IndexT* size = size_;
+    return writeFile([parent, size](int array, size_t from, size_t to, IndexT* block) {
+      memcpy(block, (array == 0 ? parent : size) + from, (to - from) * sizeof(IndexT));
+    }, block);
+  }
+
+  // Maps the named file copy-on-write and checks its header.
+  void map(const char* filename) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error(std::string("failed to open ") + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(mappeduf::Header)) {
+      length_ = st.st_size;
+      void* p = mmap(nullptr, length_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+      map_ = p == MAP_FAILED ? nullptr : static_cast<char*>(p);
+    }
+    close(fd);
+    const char* error = check();
+    if (error != nullptr) {
+      if (map_ != nullptr) {
+        munmap(map_, length_);
+      }
+      throw std::runtime_error(std::string(filename) + ": " + error);
+    }
+    const mappeduf::Header& h = header();
+    n_ = h.n;
+    count_ = static_cast<IndexT>(h.count);
+    generation_ = h.generation;
+    parent_ = reinterpret_cast<IndexT*>(map_ + sizeof(mappeduf::Header));
+    size_ = reinterpret_cast<IndexT*>(map_ + h.size_offset);
+  }
+
+  // Returns what is wrong with the mapped header, or nullptr if it is valid.
+  const char* check() const {
+    using namespace mappeduf;
+    if (map_ == nullptr) {
+      return "not a union-find file";
+    }
+    const Header& h = header();
+    if (memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+      return "not a union-find file";
+    }
+    if (h.version != kVersion) {
+      return "unsupported union-find file version";
+    }
+    if (h.header_checksum != headerChecksum(h)) {
+      return "corrupt union-find header";
+    }
+    if (h.index_bytes != sizeof(IndexT)) {
+      return "union-find file has a different index type";
+    }
+    if (h.n > static_cast<uint64_t>(static_cast<IndexT>(~IndexT(0))) || h.count > h.n ||
+        h.size_offset != sizeOffset(h.n)) {
+      return "corrupt union-find header";
+    }
+    if (fileLength(h.n) != length_) {
+      return "truncated union-find file";
+    }
+    return nullptr;
+  }
+
+ private:
+  char* map_;               // the whole file, copy-on-write
+  size_t length_;           // file size in bytes
+  IndexT* parent_;          // parent_[i] = parent of i
+  IndexT* size_;            // size_[r] = number of elements under root r
+  size_t n_;                // number of elements
+  IndexT count_;            // number of components
+  uint64_t generation_;     // snapshots saved or in progress
+  pid_t child_;             // process writing a snapshot, or -1
+  std::string filename_;
+  std::string tmp_;         // filename_ + ".tmp"
+  std::string dir_;         // directory holding filename_
+}; // class MappedUnionFind
+
+#endif // FUNDAMENTALS_MAPPED_UNION_FIND_H_
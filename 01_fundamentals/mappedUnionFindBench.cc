@@ -0,0 +1,130 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 mappedUnionFindBench.cc -o mappedUnionFindBench
+ *  Execution:  ./mappedUnionFindBench [file [n [m]]]
+ *  Dependencies: mappedUnionFind.h unionFind.h searchIndex.h
+ *                weightedQuickUnionPathCompressionUF.h stopwatch.h
+ *                workloads.h
+ *
+ *  MappedUnionFind against the in-RAM WeightedQuickUnionPathCompressionUF
+ *  on n elements (default 100 million): the time to build the state
+ *  with m random merges (default n), to snapshot and save it, to get it
+ *  back in a new process (rebuild for the in-RAM class, reopen for the
+ *  mapped one), and the throughput of m more operations (half merges,
+ *  half connected queries) right after that. The file (default
+ *  /tmp/mappedUnionFindBench.uf) is removed at the end.
+ *
+ *  % ./mappedUnionFindBench
+ *  in RAM, build                         18.556834s      5.4 Mop/s
+ *  in RAM, operations after rebuild      10.999630s      9.1 Mop/s
+ *  mapped, create file                    0.970411s
+ *  mapped, snapshot (pause)               0.019425s
+ *  mapped, build with one snapshot       17.257266s      5.8 Mop/s
+ *  mapped, save                           1.213256s
+ *  mapped, reopen                         0.000077s
+ *  mapped, operations after reopen       11.516605s      8.7 Mop/s
+ *  same answers
+ *
+ *  (single-core machine, file in the page cache: reopening takes 77us
+ *  instead of an 18.6s rebuild, and the first operations after it run
+ *  within 5% of the in-RAM class while the pages fault back in. The
+ *  fork pauses the build for 19ms; the 800 MB snapshot is written by
+ *  the child during the second half of the build, which is no slower
+ *  than the in-RAM one)
+ *
+ ******************************************************************************/
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "mappedUnionFind.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+#include "workloads.h"
+
+typedef MappedUnionFind<uint32_t, uf::Unchecked> MappedUF;
+
+// Runs the random merges [from, to) on uf.
+template <typename UF>
+void build(UF& uf, uint64_t n, uint64_t from, uint64_t to) {
+  for (uint64_t i = from; i < to; i++) {
+    uint64_t p = workload::below(workload::mix(0, 2 * i), n);
+    uint64_t q = workload::below(workload::mix(0, 2 * i + 1), n);
+    uf.merge(p, q);
+  }
+}
+
+// Runs m operations on uf, even ones merges and odd ones queries;
+// returns the number of queries answered true.
+template <typename UF>
+uint64_t operate(UF& uf, uint64_t n, uint64_t m) {
+  uint64_t connected = 0;
+  for (uint64_t i = 0; i < m; i++) {
+    uint64_t p = workload::below(workload::mix(0, ~(2 * i)), n);
+    uint64_t q = workload::below(workload::mix(0, ~(2 * i + 1)), n);
+    if (i % 2 == 0) {
+      uf.merge(p, q);
+    } else {
+      connected += uf.connected(p, q);
+    }
+  }
+  return connected;
+}
+
+void row(const char* what, double seconds, uint64_t ops) {
+  if (ops == 0) {
+    printf("%-36s %10.6fs\n", what, seconds);
+  } else {
+    printf("%-36s %10.6fs %8.1f Mop/s\n", what, seconds, ops / seconds / 1e6);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  std::string file = argc > 1 ? argv[1] : "/tmp/mappedUnionFindBench.uf";
+  uint64_t n = argc > 2 ? std::stoull(argv[2]) : 100000000;
+  uint64_t m = argc > 3 ? std::stoull(argv[3]) : n;
+
+  uint64_t ram_answers;
+  uint32_t ram_count;
+  {
+    Stopwatch timer;
+    WeightedQuickUnionPathCompressionUF uf(n);
+    build(uf, n, 0, m);
+    row("in RAM, build", timer.elapsedTime(), m);
+    Stopwatch steady;
+    ram_answers = operate(uf, n, m);
+    row("in RAM, operations after rebuild", steady.elapsedTime(), m);
+    ram_count = uf.count();
+  }
+
+  {
+    Stopwatch timer;
+    MappedUF uf(file.c_str(), n);
+    row("mapped, create file", timer.elapsedTime(), 0);
+    Stopwatch merges;
+    build(uf, n, 0, m / 2);
+    Stopwatch fork;
+    uf.snapshot();
+    row("mapped, snapshot (pause)", fork.elapsedTime(), 0);
+    build(uf, n, m / 2, m);
+    uf.waitSnapshot();
+    row("mapped, build with one snapshot", merges.elapsedTime(), m);
+    Stopwatch save;
+    uf.save();
+    row("mapped, save", save.elapsedTime(), 0);
+  }
+
+  Stopwatch timer;
+  MappedUF uf(file.c_str());
+  row("mapped, reopen", timer.elapsedTime(), 0);
+  Stopwatch steady;
+  uint64_t answers = operate(uf, n, m);
+  row("mapped, operations after reopen", steady.elapsedTime(), m);
+
+  printf("%s\n", answers == ram_answers && uf.count() == ram_count ? "same answers"
+                                                                   : "ANSWERS DIFFER");
+  unlink(file.c_str());
+  return 0;
+}
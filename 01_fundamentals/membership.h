@@ -0,0 +1,75 @@
+/******************************************************************************
+ *  Header:       membership.h
+ *  Dependencies: bitmapSet.h bloomFilter.h flatHashSet.h
+ *
+ *  Picks a membership structure for an allowlist from its size and range.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_MEMBERSHIP_H_
+#define FUNDAMENTALS_MEMBERSHIP_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "bitmapSet.h"
+#include "bloomFilter.h"
+#include "flatHashSet.h"
+
+namespace membership {
+
+// The structures an allowlist filter can answer membership queries with.
+enum Backend {
+  kSorted,    // bsearch() over the sorted array: 4 bytes per key
+  kBitmap,    // BitmapSet: one bit per value of the key range
+  kHash,      // FlatHashSet: 6 to 12 bytes per key
+  kBloom      // BloomFilter in front of the sorted array: 6 bytes per key
+};
+
+// Default memory budget of choose().
+const size_t kDefaultBudget = size_t(1) << 30;
+
+// Returns the name of the bsearch method that uses the backend.
+inline const char* name(Backend backend) {
+  switch (backend) {
+    case kBitmap: return "bitmap";
+    case kHash: return "hash";
+    case kBloom: return "bloom";
+    default: return "binary";
+  }
+}
+
+// Returns the fastest backend for the sorted keys sorted[0..n) that fits
+// in max_bytes, going by membershipBench on random queries:
+//
+//  - the bitmap answers in one bit test, 4-25x faster than the hash set,
+//    so it wins whenever its range costs no more than the hash set's
+//    worst case, 16 bytes (128 bits) per key;
+//  - the hash set is 5-15x faster than bsearch() at every size, and
+//    pulls further ahead as the array outgrows the caches;
+//  - the Bloom filter adds 2 bytes per key to the array and turns most
+//    misses into one cache line read, 3-7x faster than bsearch() when
+//    most queries miss; hits still pay for the full search.
+//
+// Falls back to the sorted array alone when nothing else fits.
+inline Backend choose(const int* sorted, size_t n, size_t max_bytes = kDefaultBudget) {
+  if (n == 0) {
+    return kSorted;
+  }
+  uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(sorted[n - 1]) - sorted[0]) + 1;
+  uint64_t bitmap_bytes = range / 8;
+  if (range <= 128 * static_cast<uint64_t>(n) && bitmap_bytes <= max_bytes) {
+    return kBitmap;
+  }
+  if (FlatHashSet::slotsFor(n) * (1 + sizeof(int)) <= max_bytes) {
+    return kHash;
+  }
+  if (n * (sizeof(int) + 2) <= max_bytes) {
+    return kBloom;
+  }
+  return kSorted;
+}
+
+} // namespace membership
+
+#endif // FUNDAMENTALS_MEMBERSHIP_H_
@@ -0,0 +1,126 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 membershipBench.cc -o membershipBench
+ *  Execution:  ./membershipBench [n ...]
+ *  Dependencies: bitmapSet.h bloomFilter.h bsearch.h flatHashSet.h hashing.h
+ *                queryBench.h stopwatch.h
+ *
+ *  Space and per-query latency of the allowlist membership backends on
+ *  n distinct random keys (default: 1K, 1M and 16M) spread over a range
+ *  of 2n, 64n or all 2^32 ints, probed by 4M queries of which 50% or 1%
+ *  are hits:
+ *
+ *    sorted      bsearch() over the sorted array
+ *    bitmap      BitmapSet (skipped when larger than 1 GB)
+ *    hash        FlatHashSet
+ *    bloom       BloomFilter in front of bsearch()
+ *
+ *  % ./membershipBench
+ *           n  range hits            sorted          bitmap            hash           bloom
+ *        1000     2n  50%     71.7 ns  4.0B    1.9 ns  0.4B   13.6 ns  6.5B   62.6 ns  6.0B
+ *        1000     2n   1%     70.9 ns  4.0B    1.8 ns  0.4B   18.0 ns  6.5B   47.6 ns  6.0B
+ *        1000    64n  50%     73.7 ns  4.0B    1.3 ns  8.1B   14.5 ns 10.4B   55.9 ns  6.1B
+ *        1000    64n   1%     78.6 ns  4.0B    2.0 ns  8.1B    7.3 ns 10.4B   20.9 ns  6.1B
+ *        1000   2^32  50%     85.2 ns  4.0B   16.3 ns 536230.7B   15.5 ns 10.3B   61.3 ns  6.0B
+ *        1000   2^32   1%     83.2 ns  4.0B   21.2 ns 536230.7B    6.6 ns 10.3B   17.7 ns  6.0B
+ *     1000000     2n  50%    248.2 ns  4.0B    2.1 ns  0.3B   25.8 ns  6.7B  228.9 ns  6.0B
+ *     1000000     2n   1%    238.8 ns  4.0B    2.3 ns  0.3B   27.8 ns  6.7B  131.2 ns  6.0B
+ *     1000000    64n  50%    243.8 ns  4.0B    6.4 ns  8.1B   28.3 ns 10.6B  155.0 ns  6.0B
+ *     1000000    64n   1%    241.8 ns  4.0B    6.9 ns  8.1B   17.8 ns 10.6B   35.6 ns  6.0B
+ *     1000000   2^32  50%    238.7 ns  4.0B   21.2 ns 536.9B   33.7 ns 10.5B  161.0 ns  6.0B
+ *     1000000   2^32   1%    265.0 ns  4.0B   24.0 ns 536.9B   17.9 ns 10.5B   30.9 ns  6.0B
+ *    16000000     2n  50%    536.8 ns  4.0B    7.6 ns  0.3B   59.6 ns  6.7B  468.6 ns  6.0B
+ *    16000000     2n   1%    509.6 ns  4.0B    6.4 ns  0.3B   57.1 ns  6.7B  315.1 ns  6.0B
+ *    16000000    64n  50%    550.8 ns  4.0B   17.0 ns  8.1B   54.1 ns 10.6B  386.7 ns  6.0B
+ *    16000000    64n   1%    526.0 ns  4.0B   18.2 ns  8.1B   36.4 ns 10.6B   89.0 ns  6.0B
+ *    16000000   2^32  50%    509.6 ns  4.0B   18.4 ns 33.6B   47.1 ns 10.5B  403.2 ns  6.0B
+ *    16000000   2^32   1%    592.4 ns  4.0B   15.2 ns 33.6B   33.7 ns 10.5B   74.8 ns  6.0B
+ *
+ *  (single-core machine; B is bytes per key. Over a 2n range random
+ *  non-member queries hit about 40% of the time on their own. These
+ *  numbers set the thresholds of membership::choose())
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bitmapSet.h"
+#include "bloomFilter.h"
+#include "bsearch.h"
+#include "flatHashSet.h"
+#include "queryBench.h"
+
+int main(int argc, char* argv[]) {
+  std::vector<int> sizes = { 1000, 1000000, 16000000 };
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; i++) {
+      sizes.push_back(std::stoi(argv[i]));
+    }
+  }
+  const int kQueries = 4000000;
+
+  printf("%10s %6s %4s   %15s %15s %15s %15s\n", "n", "range", "hits",
+         "sorted", "bitmap", "hash", "bloom");
+  for (int n : sizes) {
+    for (int64_t spread : { int64_t(2), int64_t(64), int64_t(0) }) {
+      // spread 0 stands for the whole int range
+      int64_t lo = spread == 0 ? INT32_MIN : 0;
+      int64_t hi = spread == 0 ? INT32_MAX : std::min<int64_t>(INT32_MAX, spread * n - 1);
+      std::mt19937 rng(n);
+      std::uniform_int_distribution<int64_t> key(lo, hi);
+      std::vector<int> arr(n);
+      for (int& x : arr) {
+        x = key(rng);
+      }
+      std::sort(arr.begin(), arr.end());
+      arr.erase(std::unique(arr.begin(), arr.end()), arr.end());
+
+      BitmapSet* bitmap = nullptr;
+      if (hi - lo < (int64_t(8) << 30)) {
+        bitmap = new BitmapSet(arr);
+      }
+      FlatHashSet hash(arr);
+      BloomFilter bloom(arr);
+      double keys = arr.size();
+
+      for (int hit_percent : { 50, 1 }) {
+        std::uniform_int_distribution<size_t> pick(0, arr.size() - 1);
+        std::vector<int> queries(kQueries);
+        for (int& x : queries) {
+          x = rng() % 100 < static_cast<unsigned>(hit_percent) ? arr[pick(rng)] : key(rng);
+        }
+        long long hits[4] = { 0 };
+        double sorted = nsPerQuery(queries, [&arr](int k) { return bsearch(arr, k) != -1; },
+                                   &hits[0]);
+        double bits = bitmap == nullptr ? 0 :
+            nsPerQuery(queries, [bitmap](int k) { return bitmap->contains(k); }, &hits[1]);
+        double hashed = nsPerQuery(queries, [&hash](int k) { return hash.contains(k); },
+                                   &hits[2]);
+        double bloomed = nsPerQuery(queries, [&bloom, &arr](int k) {
+          return bloom.mayContain(k) && bsearch(arr, k) != -1;
+        }, &hits[3]);
+        bool agree = hits[0] == hits[2] && hits[0] == hits[3] &&
+                     (bitmap == nullptr || hits[0] == hits[1]);
+
+        std::string range = spread == 0 ? "2^32" : std::to_string(spread) + "n";
+        printf("%10d %6s %3d%%", n, range.c_str(), hit_percent);
+        printf("   %6.1f ns %4.1fB", sorted, 4.0);
+        if (bitmap == nullptr) {
+          printf(" %15s", "-");
+        } else {
+          printf(" %6.1f ns %4.1fB", bits, bitmap->bytes() / keys);
+        }
+        printf(" %6.1f ns %4.1fB", hashed, hash.bytes() / keys);
+        printf(" %6.1f ns %4.1fB", bloomed, 4.0 + bloom.bytes() / keys);
+        printf("%s\n", agree ? "" : "  hits differ!");
+      }
+      delete bitmap;
+    }
+  }
+  return 0;
+}
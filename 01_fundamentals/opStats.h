@@ -0,0 +1,337 @@
+/******************************************************************************
+ *  Header:       opStats.h
+ *  Dependencies:
+ *
+ *  Per-operation statistics of the union-find and binary search hot
+ *  paths, compiled in with -DALGS4_STATS and out otherwise.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_OP_STATS_H_
+#define FUNDAMENTALS_OP_STATS_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#ifdef ALGS4_STATS
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <vector>
+#endif
+
+/**
+ * The hot paths report what they do through the functions below:
+ *
+ *   - opstats::record(metric, value) adds value to the histogram of
+ *     metric, for counts such as the parent links a find follows;
+ *   - an opstats::Sample object times its scope, for one operation in
+ *     kSampleEvery, so that reading the clock stays off most calls.
+ *
+ * Without ALGS4_STATS both are empty inline functions, the counts fed to
+ * them are dead code, and the optimizer removes all of it: the hot paths
+ * compile to the same instructions as they would without the calls.
+ * With it, each thread fills its own histograms (plain loads and stores,
+ * no locked instructions) and snapshot() adds them up. The histograms
+ * have power-of-two buckets: bucket 0 counts zeros, bucket k the values
+ * in [2^(k-1), 2^k).
+ *
+ * A driver calls opstats::dumpJsonAtExit() first thing in main; with
+ * ALGS4_STATS the statistics of the whole run are then written as JSON
+ * at exit, to the file named by the ALGS4_STATS_JSON environment
+ * variable or else to standard error, and without it nothing happens.
+ */
+
+namespace opstats {
+
+#ifdef ALGS4_STATS
+const bool kEnabled = true;
+#else
+const bool kEnabled = false;
+#endif
+
+enum Metric {
+  kFindHops,        // parent links followed per find
+  kFindWrites,      // parent links changed per find (path compression)
+  kFindNanos,       // sampled find latency
+  kMergeNanos,      // sampled merge latency, finds included
+  kBsearchProbes,   // keys compared per bsearch()
+  kBsearchNanos,    // sampled bsearch() latency
+  kMetrics
+};
+
+inline const char* name(Metric m) {
+  static const char* const kNames[kMetrics] = {
+    "uf.find.hops", "uf.find.writes", "uf.find.ns", "uf.merge.ns",
+    "bsearch.probes", "bsearch.ns"
+  };
+  return kNames[m];
+}
+
+// One operation in kSampleEvery is timed.
+const uint32_t kSampleEvery = 1024;
+
+// Histogram of non-negative values with power-of-two buckets.
+struct Histogram {
+  static const int kBuckets = 65;
+
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+  uint64_t buckets[kBuckets] = { };
+
+  static int bucketOf(uint64_t v) { return v == 0 ? 0 : 64 - __builtin_clzll(v); }
+
+  // Returns the smallest value of bucket b.
+  static uint64_t lowest(int b) { return b == 0 ? 0 : uint64_t(1) << (b - 1); }
+
+  void record(uint64_t v) {
+    count++;
+    sum += v;
+    max = v > max ? v : max;
+    buckets[bucketOf(v)]++;
+  }
+
+  double mean() const { return count == 0 ? 0.0 : static_cast<double>(sum) / count; }
+
+  // Returns an upper bound on the q-quantile: the largest value of the
+  // bucket holding it, capped at max.
+  uint64_t quantile(double q) const {
+    uint64_t rank = static_cast<uint64_t>(q * count);
+    uint64_t seen = 0;
+    for (int b = 0; b < kBuckets; b++) {
+      seen += buckets[b];
+      if (seen > rank) {
+        uint64_t top = b == 0 ? 0 : (b == 64 ? ~uint64_t(0) : (uint64_t(1) << b) - 1);
+        return top < max ? top : max;
+      }
+    }
+    return max;
+  }
+};
+
+// The statistics of every thread, added up.
+struct Snapshot {
+  Histogram metric[kMetrics];
+
+  // Writes the snapshot as one JSON object.
+  void writeJson(FILE* f) const {
+    fprintf(f, "{\n  \"enabled\": %s,\n  \"sample_every\": %u,\n  \"metrics\": {",
+            kEnabled ? "true" : "false", kSampleEvery);
+    for (int m = 0; m < kMetrics; m++) {
+      const Histogram& h = metric[m];
+      fprintf(f, "%s\n    \"%s\": {\"count\": %llu, \"sum\": %llu, \"mean\": %.3f, "
+              "\"max\": %llu, \"p50\": %llu, \"p99\": %llu, \"buckets\": [",
+              m == 0 ? "" : ",", name(static_cast<Metric>(m)),
+              static_cast<unsigned long long>(h.count), static_cast<unsigned long long>(h.sum),
+              h.mean(), static_cast<unsigned long long>(h.max),
+              static_cast<unsigned long long>(h.quantile(0.5)),
+              static_cast<unsigned long long>(h.quantile(0.99)));
+      const char* separator = "";
+      for (int b = 0; b < Histogram::kBuckets; b++) {
+        if (h.buckets[b] != 0) {
+          fprintf(f, "%s[%llu, %llu]", separator,
+                  static_cast<unsigned long long>(Histogram::lowest(b)),
+                  static_cast<unsigned long long>(h.buckets[b]));
+          separator = ", ";
+        }
+      }
+      fprintf(f, "]}");
+    }
+    fprintf(f, "\n  }\n}\n");
+  }
+};
+
+#ifdef ALGS4_STATS
+
+namespace detail {
+
+// A histogram written by one thread and read by snapshot() from another:
+// relaxed atomics, updated with a load and a store rather than a locked
+// read-modify-write since there is a single writer.
+struct ThreadHistogram {
+  std::atomic<uint64_t> count{0};
+  std::atomic<uint64_t> sum{0};
+  std::atomic<uint64_t> max{0};
+  std::atomic<uint64_t> buckets[Histogram::kBuckets] = { };
+
+  static void bump(std::atomic<uint64_t>& a, uint64_t d) {
+    a.store(a.load(std::memory_order_relaxed) + d, std::memory_order_relaxed);
+  }
+
+  void record(uint64_t v) {
+    bump(count, 1);
+    bump(sum, v);
+    if (v > max.load(std::memory_order_relaxed)) {
+      max.store(v, std::memory_order_relaxed);
+    }
+    bump(buckets[Histogram::bucketOf(v)], 1);
+  }
+
+  void addTo(Histogram* h) const {
+    h->count += count.load(std::memory_order_relaxed);
+    h->sum += sum.load(std::memory_order_relaxed);
+    uint64_t m = max.load(std::memory_order_relaxed);
+    h->max = m > h->max ? m : h->max;
+    for (int b = 0; b < Histogram::kBuckets; b++) {
+      h->buckets[b] += buckets[b].load(std::memory_order_relaxed);
+    }
+  }
+};
+
+struct ThreadStats;
+
+// The live threads' statistics plus the totals of the finished ones.
+// Never destroyed, so that threads finishing during exit and the dump at
+// exit can still use it.
+struct Registry {
+  std::mutex mutex;
+  std::vector<ThreadStats*> live;
+  Snapshot retired;
+
+  static Registry& get() {
+    static Registry* registry = new Registry;
+    return *registry;
+  }
+};
+
+struct ThreadStats {
+  ThreadHistogram metric[kMetrics];
+  uint32_t tick[kMetrics] = { };
+
+  ThreadStats() {
+    Registry& r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.live.push_back(this);
+  }
+
+  ~ThreadStats() {
+    Registry& r = Registry::get();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (int m = 0; m < kMetrics; m++) {
+      metric[m].addTo(&r.retired.metric[m]);
+    }
+    for (size_t i = 0; i < r.live.size(); i++) {
+      if (r.live[i] == this) {
+        r.live[i] = r.live.back();
+        r.live.pop_back();
+        break;
+      }
+    }
+  }
+
+  static ThreadStats& get() {
+    thread_local ThreadStats stats;
+    return stats;
+  }
+};
+
+} // namespace detail
+
+inline void record(Metric m, uint64_t value) {
+  detail::ThreadStats::get().metric[m].record(value);
+}
+
+// Times its scope, one time in kSampleEvery, into metric m.
+class Sample {
+ public:
+  explicit Sample(Metric m) : metric_(m), timed_(false) {
+    uint32_t& tick = detail::ThreadStats::get().tick[m];
+    if (++tick == kSampleEvery) {
+      tick = 0;
+      timed_ = true;
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+
+  Sample(const Sample&) = delete;
+  Sample& operator=(const Sample&) = delete;
+
+  ~Sample() {
+    if (timed_) {
+      auto elapsed = std::chrono::steady_clock::now() - start_;
+      record(metric_, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+  }
+
+ private:
+  Metric metric_;
+  bool timed_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Returns the statistics of all threads so far.
+inline Snapshot snapshot() {
+  detail::Registry& r = detail::Registry::get();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  Snapshot s = r.retired;
+  for (const detail::ThreadStats* t : r.live) {
+    for (int m = 0; m < kMetrics; m++) {
+      t->metric[m].addTo(&s.metric[m]);
+    }
+  }
+  return s;
+}
+
+// Zeroes the statistics of all threads. Counts recorded concurrently by
+// other threads may survive.
+inline void reset() {
+  detail::Registry& r = detail::Registry::get();
+  std::lock_guard<std::mutex> lock(r.mutex);
+  r.retired = Snapshot();
+  for (detail::ThreadStats* t : r.live) {
+    for (int m = 0; m < kMetrics; m++) {
+      detail::ThreadHistogram& h = t->metric[m];
+      h.count.store(0, std::memory_order_relaxed);
+      h.sum.store(0, std::memory_order_relaxed);
+      h.max.store(0, std::memory_order_relaxed);
+      for (auto& b : h.buckets) {
+        b.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+}
+
+inline void writeJsonAtExit() {
+  const char* path = getenv("ALGS4_STATS_JSON");
+  FILE* f = path != nullptr ? fopen(path, "w") : stderr;
+  if (f == nullptr) {
+    perror(path);
+    return;
+  }
+  snapshot().writeJson(f);
+  if (f != stderr) {
+    fclose(f);
+  }
+}
+
+inline void dumpJsonAtExit() {
+  static bool registered = false;
+  if (!registered) {
+    registered = true;
+    atexit(writeJsonAtExit);
+  }
+}
+
+#else
+
+inline void record(Metric, uint64_t) { }
+
+class Sample {
+ public:
+  explicit Sample(Metric) { }
+  Sample(const Sample&) = delete;
+  Sample& operator=(const Sample&) = delete;
+};
+
+inline Snapshot snapshot() { return Snapshot(); }
+inline void reset() { }
+inline void dumpJsonAtExit() { }
+
+#endif // ALGS4_STATS
+
+} // namespace opstats
+
+#endif // FUNDAMENTALS_OP_STATS_H_
@@ -0,0 +1,135 @@
+/******************************************************************************
+ *  Header:       packedUnionFind.h
+ *  Dependencies: unionFind.h
+ *
+ *  Union-find in a single array: roots store their size or rank.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_PACKED_UNION_FIND_H_
+#define FUNDAMENTALS_PACKED_UNION_FIND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "unionFind.h"
+
+ /**
+  * The PackedUnionFind class template is a weighted quick-union with
+  * path halving, like UnionFind<IndexT, uf::BySize, uf::PathHalving>,
+  * that keeps everything in one array of signed ids:
+  *
+  *   - parent_[i] >= 0 is the parent of the non-root i;
+  *   - parent_[r] < 0 marks the root r and holds -size (uf::BySize) or
+  *     -(rank + 1) (uf::ByRank) of its tree.
+  *
+  * That halves the memory of a separate size array, and a merge reads
+  * and writes each root in a single slot, one cache line instead of two.
+  * With IndexT = int64_t the ids go beyond 2^31 elements; int32_t covers
+  * up to 2^31 - 1 elements at 4 bytes each.
+  *
+  * find and merge take O(log n) time in the worst case and O(alpha(n))
+  * amortized; the constructor takes theta(n) time.
+  */
+
+template <typename IndexT = int32_t,
+          typename LinkPolicy = uf::BySize,
+          typename CheckPolicy = uf::Checked>
+class PackedUnionFind {
+  static_assert(std::is_signed<IndexT>::value, "IndexT must be a signed integer");
+  static_assert(std::is_same<LinkPolicy, uf::BySize>::value ||
+                std::is_same<LinkPolicy, uf::ByRank>::value,
+                "LinkPolicy must be uf::BySize or uf::ByRank");
+
+ public:
+  typedef IndexT Index;
+  static const bool kNoexcept = !CheckPolicy::kThrows;
+
+  // Initializes an empty union-find data structure with n elements
+  // 0 through n - 1. Initially, each element is in its own set.
+  explicit PackedUnionFind(size_t n) : parent_(n, -1), count_(n) { }
+
+  // Returns the number of elements.
+  size_t size() const { return parent_.size(); }
+
+  // Returns the number of bytes the structure occupies.
+  size_t bytes() const { return sizeof(*this) + parent_.capacity() * sizeof(IndexT); }
+
+  // Returns the number of sets.
+  IndexT count() const { return count_; }
+
+  // Returns the canonical element of the set containing element p.
+  IndexT find(IndexT p) noexcept(kNoexcept) {
+    validate(p);
+    opstats::Sample sample(opstats::kFindNanos);
+    IndexT* parent = parent_.data();
+    uint64_t hops = 0;
+    while (parent[p] >= 0) {
+      IndexT q = parent[p];
+      IndexT g = parent[q];
+      if (g < 0) {
+        opstats::record(opstats::kFindHops, hops + 1);
+        opstats::record(opstats::kFindWrites, hops);
+        return q;
+      }
+      parent[p] = g;
+      p = g;
+      hops++;
+    }
+    opstats::record(opstats::kFindHops, hops);
+    opstats::record(opstats::kFindWrites, hops);
+    return p;
+  }
+
+  // Returns true if p and q are in the same set.
+  bool connected(IndexT p, IndexT q) noexcept(kNoexcept) {
+    return find(p) == find(q);
+  }
+
+  // Merges the set containing element p with the set containing element
+  // q; returns false if they were already the same set.
+  bool merge(IndexT p, IndexT q) noexcept(kNoexcept) {
+    opstats::Sample sample(opstats::kMergeNanos);
+    IndexT a = find(p);
+    IndexT b = find(q);
+    if (a == b) {
+      return false;
+    }
+    IndexT* parent = parent_.data();
+    // the weights are negated, so the larger tree has the smaller value;
+    // ties hang b below a as UnionFind does
+    if (parent[a] > parent[b]) {
+      std::swap(a, b);
+    }
+    if (std::is_same<LinkPolicy, uf::BySize>::value) {
+      parent[a] += parent[b];
+    } else if (parent[a] == parent[b]) {
+      parent[a]--;
+    }
+    parent[b] = a;
+    count_--;
+    return true;
+  }
+
+  // Returns the height of the tallest tree; see uf::height.
+  size_t height() const {
+    return uf::height(parent_.size(), [this](size_t i) {
+      return parent_[i] < 0 ? i : static_cast<size_t>(parent_[i]);
+    });
+  }
+
+ private:
+  void validate(IndexT p) const noexcept(kNoexcept) {
+    CheckPolicy::validate(static_cast<typename std::make_unsigned<IndexT>::type>(p),
+                          parent_.size());
+  }
+
+ private:
+  std::vector<IndexT> parent_;  // parent_[i] = parent of i, or -weight of a root
+  IndexT count_;                // number of components
+}; // class PackedUnionFind
+
+#endif // FUNDAMENTALS_PACKED_UNION_FIND_H_
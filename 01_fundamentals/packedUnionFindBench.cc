@@ -0,0 +1,93 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 packedUnionFindBench.cc -o packedUnionFindBench
+ *  Execution:  ./packedUnionFindBench [n [m]]
+ *  Dependencies: packedUnionFind.h unionFind.h
+ *                weightedQuickUnionPathCompressionUF.h stopwatch.h
+ *                workloads.h
+ *
+ *  Memory and merge throughput of the single-array PackedUnionFind
+ *  against the two-array layout, on m random merges over n elements
+ *  (default: n = m = 1 billion). The pairs come from a counter-based
+ *  generator rather than an array, so memory is the structure alone.
+ *  Variants that need more than 80% of physical memory are skipped.
+ *
+ *  % ./packedUnionFindBench
+ *  layout                               memory      time Mmerge/s
+ *  two arrays, size, full              7.45 GB   skipped (5.9 GB of memory)
+ *  two arrays, size, halving           7.45 GB   skipped (5.9 GB of memory)
+ *  packed int32, size, halving         3.73 GB   150.58s      6.6  161916238 components
+ *  packed int32, rank, halving         3.73 GB   145.68s      6.9  161916238 components
+ *  packed int64, size, halving         7.45 GB   skipped (5.9 GB of memory)
+ *
+ *  % ./packedUnionFindBench 250000000
+ *  layout                               memory      time Mmerge/s
+ *  two arrays, size, full              1.86 GB    38.72s      6.5  40478336 components
+ *  two arrays, size, halving           1.86 GB    33.94s      7.4  40478336 components
+ *  packed int32, size, halving         0.93 GB    29.70s      8.4  40478336 components
+ *  packed int32, rank, halving         0.93 GB    28.99s      8.6  40478336 components
+ *  packed int64, size, halving         1.86 GB    29.18s      8.6  40478336 components
+ *
+ *  (single-core machine with 6 GB of memory: the billion-element
+ *  instance only fits in the packed int32 layout. At 250M elements the
+ *  packed layout is 13-15% faster than two arrays with the same
+ *  halving, and even with 64-bit ids it matches the memory of the
+ *  32-bit two-array layout)
+ *
+ ******************************************************************************/
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "packedUnionFind.h"
+#include "stopwatch.h"
+#include "unionFind.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+#include "workloads.h"
+
+// Runs m random merges on a UF of n elements that takes bytes_per_element
+// and prints its row.
+template <typename UF>
+void run(const char* name, size_t bytes_per_element, uint64_t n, uint64_t m) {
+  double gb = static_cast<double>(bytes_per_element) * n / (1 << 30);
+  double ram = static_cast<double>(sysconf(_SC_PHYS_PAGES)) * sysconf(_SC_PAGESIZE) / (1 << 30);
+  if (gb > 0.8 * ram) {
+    printf("%-32s %7.2f GB   skipped (%.1f GB of memory)\n", name, gb, ram);
+    return;
+  }
+  Stopwatch timer;
+  UF uf(n);
+  double init = timer.elapsedTime();
+  uint64_t merged = 0;
+  for (uint64_t i = 0; i < m; i++) {
+    uint64_t x = workload::mix(0, 2 * i);
+    uint64_t y = workload::mix(0, 2 * i + 1);
+    merged += uf.merge(workload::below(x, n), workload::below(y, n));
+  }
+  double elapsed = timer.elapsedTime() - init;
+  printf("%-32s %7.2f GB %8.2fs %8.1f  %llu components\n", name, gb, elapsed,
+         m / elapsed / 1e6, static_cast<unsigned long long>(n - merged));
+}
+
+int main(int argc, char* argv[]) {
+  uint64_t n = argc > 1 ? std::stoull(argv[1]) : 1000000000;
+  uint64_t m = argc > 2 ? std::stoull(argv[2]) : n;
+
+  printf("%-32s %10s %9s %8s\n", "layout", "memory", "time", "Mmerge/s");
+  if (n < (uint64_t(1) << 32)) {
+    run<WeightedQuickUnionPathCompressionUF>("two arrays, size, full", 8, n, m);
+    run<UnionFind<uint32_t, uf::BySize, uf::PathHalving, uf::Unchecked>>(
+        "two arrays, size, halving", 8, n, m);
+  }
+  if (n < (uint64_t(1) << 31)) {
+    run<PackedUnionFind<int32_t, uf::BySize, uf::Unchecked>>(
+        "packed int32, size, halving", 4, n, m);
+    run<PackedUnionFind<int32_t, uf::ByRank, uf::Unchecked>>(
+        "packed int32, rank, halving", 4, n, m);
+  }
+  run<PackedUnionFind<int64_t, uf::BySize, uf::Unchecked>>(
+      "packed int64, size, halving", 8, n, m);
+  return 0;
+}
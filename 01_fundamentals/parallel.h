@@ -0,0 +1,54 @@
+/******************************************************************************
+ *  Header:       parallel.h
+ *  Dependencies:
+ *
+ *  Minimal fork-join helpers on top of std::thread.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_PARALLEL_H_
+#define FUNDAMENTALS_PARALLEL_H_
+
+#include <thread>
+#include <vector>
+
+// Returns the default number of worker threads (one per hardware thread).
+inline int defaultThreads() {
+  int threads = std::thread::hardware_concurrency();
+  return threads < 1 ? 1 : threads;
+}
+
+// Splits [lo, hi) into one contiguous chunk per thread and calls
+// fn(chunk_lo, chunk_hi, t) for each chunk t in its own thread.
+// Runs inline when there is a single thread or nothing to split.
+template <typename Fn>
+void parallelChunks(long long lo, long long hi, int threads, Fn fn) {
+  long long n = hi - lo;
+  if (threads <= 1 || n < threads) {
+    fn(lo, hi, 0);
+    return;
+  }
+  std::vector<std::thread> workers;
+  workers.reserve(threads - 1);
+  for (int t = 1; t < threads; t++) {
+    workers.emplace_back([=, &fn] {
+      fn(lo + n * t / threads, lo + n * (t + 1) / threads, t);
+    });
+  }
+  fn(lo, lo + n / threads, 0);
+  for (auto& w : workers) {
+    w.join();
+  }
+}
+
+// Calls fn(i) for every i in [lo, hi), spread over the given threads.
+template <typename Fn>
+void parallelFor(long long lo, long long hi, int threads, Fn fn) {
+  parallelChunks(lo, hi, threads, [&fn](long long a, long long b, int) {
+    for (long long i = a; i < b; i++) {
+      fn(i);
+    }
+  });
+}
+
+#endif // FUNDAMENTALS_PARALLEL_H_
@@ -0,0 +1,238 @@
+/******************************************************************************
+ *  Header:       percolation.h
+ *  Dependencies: unionFind.h parallel.h workloads.h
+ *
+ *  Monte Carlo estimate of the site percolation threshold, with trials
+ *  run in parallel on reusable union-find arenas.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_PERCOLATION_H_
+#define FUNDAMENTALS_PERCOLATION_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "parallel.h"
+#include "unionFind.h"
+#include "workloads.h"
+
+ /**
+  * The PercolationTrial class runs percolation trials on an n-by-n grid:
+  * sites open one at a time, in uniformly random order, until some set
+  * of open sites connected through their four neighbours touches both
+  * the top and the bottom row. The fraction of sites then open is a
+  * sample of the percolation threshold (about 0.5927).
+  *
+  * The union-find is weighted quick-union with path compression (the
+  * WeightedQuickUnionPathCompressionUF policies, unchecked since the
+  * grid only produces valid sites). The object is an arena: the forest,
+  * the random order and the site states are allocated once and reset at
+  * the start of each trial, so trials allocate nothing.
+  *
+  * Opening a site is grid-aware where the textbook client is generic:
+  *
+  *   - the new site is a singleton, so it is its own root and needs no
+  *     find; after each merge with an open neighbour's set the root of
+  *     the union comes back from mergeRoots, so it needs none later;
+  *   - instead of virtual top and bottom sites, and the two finds per
+  *     step that asking whether they are connected costs, each root
+  *     carries two bits telling whether its set touches the top or the
+  *     bottom row. They are ORed together as sets merge, and the system
+  *     percolates as soon as one root has both.
+  *
+  * So each opening costs one find per open neighbour, whose roots are
+  * mostly a hop or two away. The order of the openings does not depend
+  * on the grid, so the sites about to be opened are prefetched.
+  */
+
+class PercolationTrial {
+ public:
+  typedef UnionFind<uint32_t, uf::BySize, uf::FullCompression, uf::Unchecked> UF;
+
+  // Allocates a trial arena for an n-by-n grid. Throws
+  // std::invalid_argument if n is 0 and std::length_error if the grid
+  // has more sites than 32-bit indices can number.
+  explicit PercolationTrial(size_t n)
+      : n_(checkSide(n)), uf_(n * n), order_(n * n), state_(n * n) { }
+
+  // Returns n if an n-by-n grid is supported; throws as the constructor
+  // does otherwise.
+  static size_t checkSide(size_t n) {
+    if (n == 0) {
+      throw std::invalid_argument("the grid must have at least one site");
+    }
+    if (n > 65535) {
+      throw std::length_error("too many sites for 32-bit indices");
+    }
+    return n;
+  }
+
+  // Returns the side of the grid.
+  size_t side() const { return n_; }
+
+  // Runs one trial, opening sites in the random order drawn from stream
+  // seed, and returns the number of sites open when the system first
+  // percolates. The same seed always gives the same trial.
+  size_t run(uint64_t seed) {
+    const size_t sites = n_ * n_;
+    uf_.reset();
+    for (size_t i = 0; i < sites; i++) {
+      order_[i] = static_cast<uint32_t>(i);
+    }
+    std::fill(state_.begin(), state_.end(), 0);
+
+    size_t ahead[kAhead];
+    for (size_t k = 0; k < kAhead && k < sites; k++) {
+      ahead[k] = k + workload::below(workload::mix(seed, k), sites - k);
+      __builtin_prefetch(&order_[ahead[k]]);
+    }
+    for (size_t k = 0; k < sites; k++) {
+      // one step of Fisher-Yates: the k-th site opened is uniform among
+      // those still closed
+      size_t j = ahead[k % kAhead];
+      size_t next = k + kAhead;
+      if (next < sites) {
+        size_t jn = next + workload::below(workload::mix(seed, next), sites - next);
+        ahead[next % kAhead] = jn;
+        __builtin_prefetch(&order_[jn]);
+      }
+      size_t soon = k + kAhead / 2;
+      if (soon < sites) {
+        prefetchSite(order_[ahead[soon % kAhead]]);
+      }
+      std::swap(order_[k], order_[j]);
+      if (open(order_[k])) {
+        return k + 1;
+      }
+    }
+    return sites;  // not reached: a full grid percolates
+  }
+
+ private:
+  // The random choices are made kAhead steps early, so the order_ slot
+  // a step swaps in is prefetched kAhead steps before, and the site it
+  // opens, with its neighbours above and below, kAhead / 2 steps before.
+  static const size_t kAhead = 16;
+  static const uint8_t kOpen = 1;
+  static const uint8_t kTop = 2;      // on a root: the set touches the top row
+  static const uint8_t kBottom = 4;   // on a root: the set touches the bottom row
+
+  // Prefetches the state and parent slots of site s and of the sites
+  // above and below it; s may be stale, since this is only a hint.
+  void prefetchSite(uint32_t s) const {
+    __builtin_prefetch(&state_[s]);
+    uf_.prefetch(s);
+    if (s >= n_) {
+      __builtin_prefetch(&state_[s - n_]);
+      uf_.prefetch(s - n_);
+    }
+    if (s + n_ < state_.size()) {
+      __builtin_prefetch(&state_[s + n_]);
+      uf_.prefetch(s + n_);
+    }
+  }
+
+  // Opens site s and returns true if the system now percolates.
+  bool open(uint32_t s) {
+    uint32_t row = s / static_cast<uint32_t>(n_);
+    uint32_t col = s - row * static_cast<uint32_t>(n_);
+    uint8_t flags = kOpen | (row == 0 ? kTop : 0) | (row + 1 == n_ ? kBottom : 0);
+    uint32_t root = s;
+    auto join = [&](uint32_t neighbour) {
+      if (state_[neighbour] & kOpen) {
+        uint32_t r = uf_.find(neighbour);
+        if (r != root) {
+          flags |= state_[r];
+          root = uf_.mergeRoots(root, r);
+        }
+      }
+    };
+    if (row > 0) {
+      join(s - n_);
+    }
+    if (row + 1 < n_) {
+      join(s + n_);
+    }
+    if (col > 0) {
+      join(s - 1);
+    }
+    if (col + 1 < n_) {
+      join(s + 1);
+    }
+    state_[s] |= kOpen;
+    state_[root] |= flags;
+    return (flags & (kTop | kBottom)) == (kTop | kBottom);
+  }
+
+ private:
+  size_t n_;                    // side of the grid
+  UF uf_;                       // the open sites' sets
+  std::vector<uint32_t> order_; // order_[0..k) are the sites opened so far
+  std::vector<uint8_t> state_;  // kOpen per site, kTop and kBottom per root
+}; // class PercolationTrial
+
+namespace percolation {
+
+// The result of estimateThreshold(): the mean and sample standard
+// deviation of the thresholds found, and the 95% confidence interval of
+// the mean. The standard deviation of a single trial is NaN.
+struct Estimate {
+  size_t trials;
+  double mean;
+  double stddev;
+  double confidenceLo;
+  double confidenceHi;
+};
+
+} // namespace percolation
+
+// Estimates the percolation threshold of the n-by-n grid from the given
+// number of independent trials, spread over threads; each thread reuses
+// one PercolationTrial arena. Trial i uses stream i of seed, so the
+// estimate depends on n, trials and seed but not on the threads.
+// Throws std::invalid_argument if n or trials is 0.
+inline percolation::Estimate estimateThreshold(size_t n, size_t trials, uint64_t seed = 1,
+                                               int threads = defaultThreads()) {
+  if (trials == 0) {
+    throw std::invalid_argument("at least one trial is needed");
+  }
+  PercolationTrial::checkSide(n);
+  std::vector<double> threshold(trials);
+  double sites = static_cast<double>(n) * n;
+  parallelChunks(0, trials, threads, [&](long long lo, long long hi, int) {
+    if (lo == hi) {
+      return;
+    }
+    PercolationTrial trial(n);
+    for (long long i = lo; i < hi; i++) {
+      threshold[i] = trial.run(workload::mix(seed, i)) / sites;
+    }
+  });
+
+  percolation::Estimate e;
+  e.trials = trials;
+  double sum = 0;
+  for (double x : threshold) {
+    sum += x;
+  }
+  e.mean = sum / trials;
+  double squares = 0;
+  for (double x : threshold) {
+    squares += (x - e.mean) * (x - e.mean);
+  }
+  e.stddev = trials > 1 ? std::sqrt(squares / (trials - 1))
+                        : std::numeric_limits<double>::quiet_NaN();
+  double half_width = 1.96 * e.stddev / std::sqrt(static_cast<double>(trials));
+  e.confidenceLo = e.mean - half_width;
+  e.confidenceHi = e.mean + half_width;
+  return e;
+}
+
+#endif // FUNDAMENTALS_PERCOLATION_H_
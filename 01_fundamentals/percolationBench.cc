@@ -0,0 +1,108 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread percolationBench.cc -o percolationBench
+ *  Execution:  ./percolationBench [threads]
+ *  Dependencies: percolation.h weightedQuickUnionPathCompressionUF.h
+ *                unionFind.h parallel.h workloads.h stopwatch.h
+ *
+ *  Percolation trials per second on n-by-n grids: the textbook client,
+ *  which builds a WeightedQuickUnionPathCompressionUF with virtual top
+ *  and bottom sites for every trial, opens random closed sites by
+ *  rejection and asks after each whether top and bottom are connected,
+ *  against estimateThreshold() on one thread and on the given number of
+ *  threads (default: one per hardware thread).
+ *
+ *  % ./percolationBench
+ *       n   trials           textbook         engine, 1 thread     engine, 1 threads
+ *      64     4000     4825/s  0.5925     7070/s  0.5919 1.47x     7085/s 1.47x
+ *     256      400      212/s  0.5923      382/s  0.5928 1.80x      356/s 1.68x
+ *    1024       40       10/s  0.5935       15/s  0.5923 1.48x       13/s 1.29x
+ *
+ *  (single-core machine, so the threads column only shows the cost of
+ *  the fork-join; timings vary by about 10% between runs. The engine
+ *  gains from needing no finds for the new site or for virtual top and
+ *  bottom sites, from allocating nothing per trial and, on the larger
+ *  grids, from prefetching the sites about to be opened)
+ *
+ ******************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "percolation.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+#include "workloads.h"
+
+// One trial of the textbook client on an n-by-n grid; returns the
+// fraction of sites open when the system percolates.
+double textbookTrial(size_t n, uint64_t seed) {
+  size_t sites = n * n;
+  size_t top = sites;
+  size_t bottom = sites + 1;
+  WeightedQuickUnionPathCompressionUF uf(sites + 2);
+  std::vector<bool> open(sites, false);
+  size_t opened = 0;
+  for (uint64_t draw = 0; !uf.connected(top, bottom); draw++) {
+    size_t s = workload::below(workload::mix(seed, draw), sites);
+    if (open[s]) {
+      continue;
+    }
+    open[s] = true;
+    opened++;
+    size_t row = s / n;
+    size_t col = s % n;
+    if (row == 0) {
+      uf.merge(s, top);
+    }
+    if (row + 1 == n) {
+      uf.merge(s, bottom);
+    }
+    if (row > 0 && open[s - n]) {
+      uf.merge(s, s - n);
+    }
+    if (row + 1 < n && open[s + n]) {
+      uf.merge(s, s + n);
+    }
+    if (col > 0 && open[s - 1]) {
+      uf.merge(s, s - 1);
+    }
+    if (col + 1 < n && open[s + 1]) {
+      uf.merge(s, s + 1);
+    }
+  }
+  return static_cast<double>(opened) / sites;
+}
+
+int main(int argc, char* argv[]) {
+  int threads = argc > 1 ? std::stoi(argv[1]) : defaultThreads();
+  printf("%6s %8s %18s %24s %21s\n", "n", "trials", "textbook", "engine, 1 thread",
+         ("engine, " + std::to_string(threads) + " threads").c_str());
+  // fewer trials on larger grids, so that every row takes a few seconds
+  const size_t kRuns[][2] = { { 64, 4000 }, { 256, 400 }, { 1024, 40 } };
+  for (const auto& run : kRuns) {
+    size_t n = run[0];
+    size_t trials = run[1];
+
+    Stopwatch textbook_timer;
+    double sum = 0;
+    for (size_t i = 0; i < trials; i++) {
+      sum += textbookTrial(n, workload::mix(1, i));
+    }
+    double textbook = textbook_timer.elapsedTime();
+
+    Stopwatch one_timer;
+    percolation::Estimate one = estimateThreshold(n, trials, 1, 1);
+    double engine_one = one_timer.elapsedTime();
+
+    Stopwatch many_timer;
+    estimateThreshold(n, trials, 1, threads);
+    double engine_many = many_timer.elapsedTime();
+
+    printf("%6zu %8zu %8.0f/s  %.4f %8.0f/s  %.4f %4.2fx %8.0f/s %4.2fx\n", n, trials,
+           trials / textbook, sum / trials, trials / engine_one, one.mean,
+           textbook / engine_one, trials / engine_many, textbook / engine_many);
+  }
+  return 0;
+}
@@ -0,0 +1,43 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread percolationStats.cc -o percolationStats
+ *  Execution:  ./percolationStats n trials [threads [seed]]
+ *  Dependencies: percolation.h unionFind.h parallel.h workloads.h
+ *
+ *  Estimates the site percolation threshold of an n-by-n grid from the
+ *  given number of independent trials, run on the given number of
+ *  threads (default: one per hardware thread). The result depends on
+ *  n, trials and seed (default 1) only.
+ *
+ *  % ./percolationStats 200 100
+ *  mean                    = 0.59309375
+ *  stddev                  = 0.0095088325
+ *  95% confidence interval = [0.59123002, 0.59495748]
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <exception>
+#include <string>
+
+#include "percolation.h"
+
+int main(int argc, char* argv[]) {
+  if (argc < 3) {
+    fprintf(stderr, "usage: %s n trials [threads [seed]]\n", argv[0]);
+    return 1;
+  }
+  try {
+    size_t n = std::stoul(argv[1]);
+    size_t trials = std::stoul(argv[2]);
+    int threads = argc > 3 ? std::stoi(argv[3]) : defaultThreads();
+    uint64_t seed = argc > 4 ? std::stoull(argv[4]) : 1;
+    percolation::Estimate e = estimateThreshold(n, trials, seed, threads);
+    printf("mean                    = %.8g\n", e.mean);
+    printf("stddev                  = %.8g\n", e.stddev);
+    printf("95%% confidence interval = [%.8g, %.8g]\n", e.confidenceLo, e.confidenceHi);
+  } catch (const std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
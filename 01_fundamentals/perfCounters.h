@@ -0,0 +1,140 @@
+/******************************************************************************
+ *  Header:       perfCounters.h
+ *  Dependencies:
+ *
+ *  Hardware event counts (cache misses, instructions) around a block of
+ *  code, through Linux perf events when the machine exposes them.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_PERF_COUNTERS_H_
+#define FUNDAMENTALS_PERF_COUNTERS_H_
+
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * The PerfCounters class counts hardware events of the calling thread,
+ * user space only, between start() and stop():
+ *
+ *   PerfCounters counters;
+ *   counters.start();
+ *   ...
+ *   counters.stop();
+ *   long long misses = counters.cacheMisses();
+ *
+ * Each event is opened separately. One that cannot be opened (no PMU,
+ * as in most virtual machines, or perf_event_paranoid forbidding it, or
+ * not Linux at all) reads as -1, and the rest still count.
+ */
+
+class PerfCounters {
+ public:
+  enum Event {
+    kCacheMisses,     // last-level cache misses
+    kInstructions,    // instructions retired
+    kBranchMisses,    // mispredicted branches
+    kEvents
+  };
+
+  PerfCounters() {
+    static const uint64_t kConfig[kEvents] = {
+#ifdef __linux__
+      PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES
+#endif
+    };
+    for (int e = 0; e < kEvents; e++) {
+      fd_[e] = open(kConfig[e]);
+      value_[e] = -1;
+    }
+  }
+
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  ~PerfCounters() {
+#ifdef __linux__
+    for (int e = 0; e < kEvents; e++) {
+      if (fd_[e] >= 0) {
+        close(fd_[e]);
+      }
+    }
+#endif
+  }
+
+  // Returns true if at least one event can be counted.
+  bool available() const {
+    for (int e = 0; e < kEvents; e++) {
+      if (fd_[e] >= 0) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Zeroes the counts and starts counting.
+  void start() {
+#ifdef __linux__
+    for (int e = 0; e < kEvents; e++) {
+      if (fd_[e] >= 0) {
+        ioctl(fd_[e], PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_[e], PERF_EVENT_IOC_ENABLE, 0);
+      }
+    }
+#endif
+  }
+
+  // Stops counting and reads the counts.
+  void stop() {
+#ifdef __linux__
+    for (int e = 0; e < kEvents; e++) {
+      if (fd_[e] >= 0) {
+        ioctl(fd_[e], PERF_EVENT_IOC_DISABLE, 0);
+        long long count;
+        value_[e] = read(fd_[e], &count, sizeof(count)) == sizeof(count) ? count : -1;
+      }
+    }
+#endif
+  }
+
+  // Returns the count of event e between the last start() and stop(), or
+  // -1 if it cannot be counted.
+  long long value(Event e) const { return value_[e]; }
+
+  long long cacheMisses() const { return value_[kCacheMisses]; }
+  long long instructions() const { return value_[kInstructions]; }
+  long long branchMisses() const { return value_[kBranchMisses]; }
+
+ private:
+  // Opens a disabled counter of the given hardware event; returns -1 if
+  // it is not available.
+  static int open(uint64_t config) {
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+    (void) config;
+    return -1;
+#endif
+  }
+
+ private:
+  int fd_[kEvents];           // perf event descriptors, -1 if unavailable
+  long long value_[kEvents];  // counts from the last stop(), -1 if unknown
+}; // class PerfCounters
+
+#endif // FUNDAMENTALS_PERF_COUNTERS_H_
@@ -0,0 +1,40 @@
+/******************************************************************************
+ *  Header:       queryBench.h
+ *  Dependencies: stopwatch.h
+ *
+ *  Per-query latency of a lookup over a batch of keys, for the search
+ *  and membership benchmarks.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_QUERY_BENCH_H_
+#define FUNDAMENTALS_QUERY_BENCH_H_
+
+#include <vector>
+
+#include "stopwatch.h"
+
+namespace querybench {
+
+// A lookup hits if it finds an index (not -1) or answers true.
+inline bool isHit(int index) { return index != -1; }
+inline bool isHit(bool found) { return found; }
+
+} // namespace querybench
+
+// Runs search over all queries; returns the average time in nanoseconds
+// and stores the number of hits. search returns an index, -1 if absent,
+// or whether the key is present.
+template <typename Search>
+double nsPerQuery(const std::vector<int>& queries, Search search, long long* hits) {
+  Stopwatch timer;
+  long long found = 0;
+  for (int key : queries) {
+    found += querybench::isHit(search(key));
+  }
+  double elapsed = timer.elapsedTime();
+  *hits = found;
+  return elapsed * 1e9 / queries.size();
+}
+
+#endif // FUNDAMENTALS_QUERY_BENCH_H_
@@ -1,7 +1,7 @@
 /******************************************************************************
  *  Compilation:  g++ quickUnionPathCompressionUF.cc -o quickUnionPathCompressionUF
  *  Execution:  ./quickUnionPathCompressionUF < input.txt
- *  Dependencies:
+ *  Dependencies: unionFind.h unionFindClient.h fastIO.h opStats.h
  *  Data files:   https://algs4.cs.princeton.edu/15uf/tinyUF.txt
  *                https://algs4.cs.princeton.edu/15uf/mediumUF.txt
  *                https://algs4.cs.princeton.edu/15uf/largeUF.txt
@@ -10,9 +10,12 @@
  *
  ******************************************************************************/
 
-#include <iostream>
-#include <vector>
-#include <stdexcept>
+#include <cstdint>
+
+#include "fastIO.h"
+#include "opStats.h"
+#include "unionFind.h"
+#include "unionFindClient.h"
 
  /**
   * The QuickUnionUF class represents a union-find data type
@@ -31,52 +34,8 @@
   * @date   Fri Dec  4 15:18:43 CST 2020
   */
 
-class QuickUnionPathCompressionUF {
- public:
-  // Initializes an empty union-find data structure with n elements
-  // 0 through n - 1. Initially, each element is in its own set.
-  QuickUnionPathCompressionUF(int n) : count_(n) {
-    parent_.reserve(n);
-    for (int i = 0; i < n; i++) {
-      parent_.push_back(i);
-    }
-  }
-
-  ~QuickUnionPathCompressionUF() { }
-
-  // Returns the number of sets.
-  int count() const { return count_; }
-
-  // Returns the canonical element of the set containing element p.
-  int find(int p) {
-    int root = p;
-    while (root != parent_[root]) {
-      root = parent_[root];
-    }
-    while (p != root) {
-      int newp = parent_[p];
-      parent_[p] = root;
-      p = newp;
-    }
-    return root;
-  }
-
-  // Merges the set containing element p with the set containing element q.
-  void merge(int p, int q) {
-    int root_p = find(p);
-    int root_q = find(q);
-    if (root_p == root_q) {
-      return;
-    }
-
-    parent_[root_p] = parent_[root_q];
-    count_--;
-  }
-
- private:
-  std::vector<int> parent_;   // parent_[i] = parent of i
-  int count_;             // number of components
-}; // class QuickUnionPathCompressionUF
+typedef UnionFind<uint32_t, uf::Naive, uf::FullCompression, uf::Checked>
+    QuickUnionPathCompressionUF;
 
 
 // Reads an integer n and a sequence of pairs of integers
@@ -85,24 +44,9 @@ class QuickUnionPathCompressionUF {
 // if the elements are in different sets, merge the two sets
 // and print the pair to standard output.
 int main(int argc, char* argv[]) {
-  int n;
-  std::cin >> n;
-  QuickUnionPathCompressionUF uf(n);
-
-  int p;
-  int q;
-  try {
-    while (std::cin >> p >> q) {
-      if (uf.find(p) == uf.find(q)) {
-        continue;
-      }
-      uf.merge(p, q);
-      std::cout << p << " " << q << std::endl;
-    }
-    std::cout << uf.count() << " components" << std::endl;
-  } catch(const std::exception& e) {
-    std::cout << e.what() << std::endl;
-  }
-
-  return 0;
+  opstats::dumpJsonAtExit();
+  In in;
+  Out out;
+  unionFindBlockClient<QuickUnionPathCompressionUF>(in, out);
+  return out.exitStatus();
 }
@@ -0,0 +1,134 @@
+/******************************************************************************
+ *  Header:       radixSort.h
+ *  Dependencies: parallel.h
+ *
+ *  Parallel LSD radix sort on 32-bit keys.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_RADIX_SORT_H_
+#define FUNDAMENTALS_RADIX_SORT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "parallel.h"
+
+namespace radix {
+
+// Maps an int to an unsigned key with the same order (flips the sign bit).
+inline uint32_t intKey(int x) { return static_cast<uint32_t>(x) ^ 0x80000000u; }
+
+// Maps a float other than NaN to an unsigned key with the same order:
+// flips the sign bit of a positive float and every bit of a negative one.
+inline uint32_t floatKey(float x) {
+  uint32_t u;
+  memcpy(&u, &x, sizeof(u));
+  return (u & 0x80000000u) != 0 ? ~u : u | 0x80000000u;
+}
+
+// The passes of radixSort over a[0..n), with aux[0..n) as scratch space;
+// returns whichever of a and aux holds the sorted elements at the end.
+template <typename T, typename Key>
+T* sortPasses(T* a, T* aux, size_t n, Key key, int threads) {
+  const int kBits = 8;
+  const int kRadix = 1 << kBits;
+  const size_t kMinPerThread = 1 << 16;
+  if (threads < 1) {
+    threads = 1;
+  }
+  if (n / threads < kMinPerThread) {
+    threads = std::max<size_t>(1, n / kMinPerThread);
+  }
+
+  T* src = a;
+  T* dst = aux;
+  std::vector<size_t> count(static_cast<size_t>(threads) * kRadix);
+  for (int shift = 0; shift < 32; shift += kBits) {
+    std::fill(count.begin(), count.end(), 0);
+    parallelChunks(0, n, threads, [&](long long lo, long long hi, int t) {
+      size_t* c = &count[static_cast<size_t>(t) * kRadix];
+      for (long long i = lo; i < hi; i++) {
+        c[(key(src[i]) >> shift) & (kRadix - 1)]++;
+      }
+    });
+
+    // turn counts into starting offsets, digit-major then thread
+    bool trivial = false;
+    size_t next = 0;
+    for (int d = 0; d < kRadix; d++) {
+      size_t start = next;
+      for (int t = 0; t < threads; t++) {
+        size_t c = count[static_cast<size_t>(t) * kRadix + d];
+        count[static_cast<size_t>(t) * kRadix + d] = next;
+        next += c;
+      }
+      if (next - start == n) {
+        trivial = true;
+      }
+    }
+    if (trivial) {
+      continue;
+    }
+
+    parallelChunks(0, n, threads, [&](long long lo, long long hi, int t) {
+      size_t* c = &count[static_cast<size_t>(t) * kRadix];
+      for (long long i = lo; i < hi; i++) {
+        dst[c[(key(src[i]) >> shift) & (kRadix - 1)]++] = src[i];
+      }
+    });
+    std::swap(src, dst);
+  }
+  return src;
+}
+
+} // namespace radix
+
+// Rearranges *a in ascending order of key(x), an unsigned 32-bit value,
+// with a stable LSD radix sort using the given number of threads.
+//
+// Each of the four passes sorts on one byte of the key: every thread
+// counts the digits of its own contiguous chunk, a prefix sum over
+// (digit, thread) gives each thread a private output range per digit,
+// and the threads scatter their chunks in parallel without any
+// synchronization. A pass is skipped when all keys share its digit,
+// which is common for the high byte of small keys.
+//
+// Takes theta(n) time and n extra elements of memory.
+template <typename T, typename Key>
+void radixSort(std::vector<T>* a, Key key, int threads = defaultThreads()) {
+  size_t n = a->size();
+  if (n < 2) {
+    return;
+  }
+  std::vector<T> aux(n);
+  if (radix::sortPasses(a->data(), aux.data(), n, key, threads) != a->data()) {
+    a->swap(aux);
+  }
+}
+
+// Rearranges [first, last) in ascending order of key(x), as above; the
+// sorted elements are copied back if they end up in the scratch space.
+template <typename T, typename Key>
+void radixSort(T* first, T* last, Key key, int threads = defaultThreads()) {
+  size_t n = last - first;
+  if (n < 2) {
+    return;
+  }
+  std::vector<T> aux(n);
+  if (radix::sortPasses(first, aux.data(), n, key, threads) != first) {
+    parallelChunks(0, n, threads, [&](long long lo, long long hi, int) {
+      std::copy(aux.begin() + lo, aux.begin() + hi, first + lo);
+    });
+  }
+}
+
+// Rearranges *a in ascending order.
+inline void radixSort(std::vector<int>* a, int threads = defaultThreads()) {
+  radixSort(a, radix::intKey, threads);
+}
+
+#endif // FUNDAMENTALS_RADIX_SORT_H_
@@ -0,0 +1,121 @@
+/******************************************************************************
+ *  Header:       rollbackUnionFind.h
+ *  Dependencies: unionFind.h
+ *
+ *  Weighted quick-union whose merges can be undone back to a checkpoint.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_ROLLBACK_UNION_FIND_H_
+#define FUNDAMENTALS_ROLLBACK_UNION_FIND_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "unionFind.h"
+
+ /**
+  * The RollbackUnionFind class template is WeightedQuickUnionUF (union
+  * by size, no path compression) plus a log of its merges, so that any
+  * suffix of them can be undone.
+  *
+  * Without compression a merge changes exactly two slots, the parent of
+  * the root that was hung and the size of the root it was hung below,
+  * and nothing else ever changes; the log records the hung root, which
+  * is enough to restore both. checkpoint() returns the current position
+  * in the log and rollback(to) undoes every merge made since.
+  *
+  * Union by size keeps the trees at most log2(n) high, so find takes
+  * O(log n) time in the worst case; merge takes O(log n) time and undoing
+  * one takes constant time. Merges of elements already in the same set
+  * change nothing and are not logged.
+  */
+
+template <typename IndexT = uint32_t, typename CheckPolicy = uf::Checked>
+class RollbackUnionFind {
+ public:
+  typedef IndexT Index;
+  static const bool kNoexcept = !CheckPolicy::kThrows;
+
+  // Initializes an empty union-find data structure with n elements
+  // 0 through n - 1. Initially, each element is in its own set.
+  explicit RollbackUnionFind(size_t n) : parent_(n), count_(n) {
+    for (size_t i = 0; i < n; i++) {
+      parent_[i] = static_cast<IndexT>(i);
+    }
+    link_.init(n);
+  }
+
+  // Returns the number of elements.
+  size_t size() const { return parent_.size(); }
+
+  // Returns the number of sets.
+  IndexT count() const { return count_; }
+
+  // Returns the canonical element of the set containing element p.
+  IndexT find(IndexT p) const noexcept(kNoexcept) {
+    CheckPolicy::validate(p, parent_.size());
+    opstats::Sample sample(opstats::kFindNanos);
+    uint64_t hops = 0;
+    while (p != parent_[p]) {
+      p = parent_[p];
+      hops++;
+    }
+    opstats::record(opstats::kFindHops, hops);
+    opstats::record(opstats::kFindWrites, 0);
+    return p;
+  }
+
+  // Returns true if p and q are in the same set.
+  bool connected(IndexT p, IndexT q) const noexcept(kNoexcept) {
+    return find(p) == find(q);
+  }
+
+  // Merges the set containing element p with the set containing element
+  // q; returns false (and logs nothing) if they were already the same set.
+  bool merge(IndexT p, IndexT q) {
+    opstats::Sample sample(opstats::kMergeNanos);
+    IndexT root_p = find(p);
+    IndexT root_q = find(q);
+    if (root_p == root_q) {
+      return false;
+    }
+    IndexT root = link_.link(parent_.data(), root_p, root_q);
+    history_.push_back(root == root_p ? root_q : root_p);
+    count_--;
+    return true;
+  }
+
+  // Returns the height of the tallest tree; see uf::height.
+  size_t height() const {
+    return uf::height(parent_.size(), [this](size_t i) { return parent_[i]; });
+  }
+
+  // Returns a checkpoint: the number of merges in the log.
+  size_t checkpoint() const { return history_.size(); }
+
+  // Undoes the merges made since checkpoint to, most recent first.
+  void rollback(size_t to) {
+    if (to > history_.size()) {
+      throw std::invalid_argument("rollback to a checkpoint past the end of the log");
+    }
+    while (history_.size() > to) {
+      IndexT child = history_.back();
+      history_.pop_back();
+      IndexT root = parent_[child];
+      link_.size[root] -= link_.size[child];
+      parent_[child] = child;
+      count_++;
+    }
+  }
+
+ private:
+  std::vector<IndexT> parent_;                    // parent_[i] = parent of i
+  uf::BySize::State<IndexT> link_;                // sizes of the roots
+  std::vector<IndexT> history_;                   // root hung by each merge
+  IndexT count_;                                  // number of components
+}; // class RollbackUnionFind
+
+#endif // FUNDAMENTALS_ROLLBACK_UNION_FIND_H_
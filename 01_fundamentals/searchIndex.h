@@ -0,0 +1,326 @@
+/******************************************************************************
+ *  Header:       searchIndex.h
+ *  Dependencies: eytzinger.h
+ *
+ *  Prebuilt, memory-mapped search index file for the allowlist filter.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_SEARCH_INDEX_H_
+#define FUNDAMENTALS_SEARCH_INDEX_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "eytzinger.h"
+
+/**
+ * An index file holds a sorted key array, ready to search in place, and
+ * optionally the same keys in Eytzinger order (see EytzingerIndex). All
+ * values are stored in native byte order:
+ *
+ *   offset 0    searchindex::Header (64 bytes)
+ *   offset 64   keys[0..count), ascending
+ *   (aligned)   slots[0..count] in Eytzinger order, if kHasEytzinger
+ *   (aligned)   rank[0..count] of the slots, if kHasEytzinger
+ *
+ * Every section starts on a 64-byte boundary and is zero-padded to one.
+ * The header carries a format version, a checksum of itself, and a
+ * checksum of everything after it.
+ */
+
+namespace searchindex {
+
+const char kMagic[8] = { 'A', 'L', 'G', 'S', '4', 'I', 'D', 'X' };
+const uint32_t kVersion = 1;
+const uint32_t kHasEytzinger = 1;
+const uint64_t kAlign = 64;
+
+struct Header {
+  char magic[8];              // kMagic
+  uint32_t version;           // kVersion
+  uint32_t flags;             // kHasEytzinger or 0
+  uint64_t count;             // number of keys
+  uint64_t keys_offset;       // byte offset of the sorted keys
+  uint64_t eytzinger_offset;  // byte offset of the Eytzinger slots, or 0
+  uint64_t rank_offset;       // byte offset of their ranks, or 0
+  uint64_t payload_checksum;  // checksum of all bytes after the header
+  uint64_t header_checksum;   // checksum of the 56 bytes above
+};
+static_assert(sizeof(Header) == 64, "index header must be one cache line");
+
+// Streaming 64-bit checksum over a byte sequence taken as little 8-byte
+// words (the last one zero-padded). One multiply per word, so verifying a
+// file runs at memory speed.
+class Checksum {
+ public:
+  Checksum() : hash_(0xcbf29ce484222325ULL), carry_(0), carried_(0) { }
+
+  void update(const void* data, size_t n) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    while (n > 0 && carried_ != 0) {
+      push(*p++);
+      n--;
+    }
+    for (; n >= 8; p += 8, n -= 8) {
+      uint64_t word;
+      memcpy(&word, p, 8);
+      mix(word);
+    }
+    while (n > 0) {
+      push(*p++);
+      n--;
+    }
+  }
+
+  uint64_t value() const {
+    uint64_t h = hash_;
+    if (carried_ != 0) {
+      h = (h ^ carry_) * 0x100000001b3ULL;
+      h ^= h >> 29;
+    }
+    return h;
+  }
+
+ private:
+  void mix(uint64_t word) {
+    hash_ = (hash_ ^ word) * 0x100000001b3ULL;
+    hash_ ^= hash_ >> 29;
+  }
+
+  void push(unsigned char byte) {
+    carry_ |= static_cast<uint64_t>(byte) << (8 * carried_);
+    if (++carried_ == 8) {
+      mix(carry_);
+      carry_ = 0;
+      carried_ = 0;
+    }
+  }
+
+  uint64_t hash_;
+  uint64_t carry_;    // bytes of an incomplete word
+  int carried_;       // number of bytes in carry_
+}; // class Checksum
+
+inline uint64_t alignUp(uint64_t x) { return (x + kAlign - 1) / kAlign * kAlign; }
+
+inline uint64_t headerChecksum(const Header& h) {
+  Checksum c;
+  c.update(&h, offsetof(Header, header_checksum));
+  return c.value();
+}
+
+} // namespace searchindex
+
+// Writes the keys sorted[0..n) (ascending), and their Eytzinger layout if
+// eytzinger is true, to the named index file. The file is written under a
+// temporary name and renamed into place, so readers never see a partial
+// index. Throws std::runtime_error on I/O failure.
+inline void writeSearchIndex(const char* filename, const int* sorted, size_t n,
+                             bool eytzinger) {
+  using namespace searchindex;
+  Header h;
+  memset(&h, 0, sizeof(h));
+  memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.version = kVersion;
+  h.flags = eytzinger ? kHasEytzinger : 0;
+  h.count = n;
+  h.keys_offset = sizeof(Header);
+  if (eytzinger) {
+    h.eytzinger_offset = alignUp(h.keys_offset + n * sizeof(int));
+    h.rank_offset = alignUp(h.eytzinger_offset + (n + 1) * sizeof(int));
+  }
+
+  std::vector<const int*> sections = { sorted };
+  std::vector<size_t> lengths = { n };
+  std::unique_ptr<EytzingerIndex> layout;
+  if (eytzinger) {
+    layout.reset(new EytzingerIndex(sorted, n));
+    sections.push_back(layout->layout());
+    lengths.push_back(n + 1);
+    sections.push_back(layout->ranks());
+    lengths.push_back(n + 1);
+  }
+
+  Checksum payload;
+  static const char zeros[kAlign] = { 0 };
+  for (size_t i = 0; i < sections.size(); i++) {
+    size_t bytes = lengths[i] * sizeof(int);
+    payload.update(sections[i], bytes);
+    payload.update(zeros, alignUp(bytes) - bytes);
+  }
+  h.payload_checksum = payload.value();
+  h.header_checksum = headerChecksum(h);
+
+  std::string tmp = std::string(filename) + ".tmp";
+  FILE* f = fopen(tmp.c_str(), "wb");
+  bool ok = f != nullptr && fwrite(&h, sizeof(h), 1, f) == 1;
+  for (size_t i = 0; ok && i < sections.size(); i++) {
+    size_t bytes = lengths[i] * sizeof(int);
+    ok = fwrite(sections[i], 1, bytes, f) == bytes &&
+         fwrite(zeros, 1, alignUp(bytes) - bytes, f) == alignUp(bytes) - bytes;
+  }
+  if (f != nullptr && fclose(f) != 0) {
+    ok = false;
+  }
+  if (!ok || rename(tmp.c_str(), filename) != 0) {
+    remove(tmp.c_str());
+    throw std::runtime_error(std::string("failed to write ") + filename);
+  }
+}
+
+inline void writeSearchIndex(const char* filename, const std::vector<int>& sorted,
+                             bool eytzinger) {
+  writeSearchIndex(filename, sorted.data(), sorted.size(), eytzinger);
+}
+
+/**
+ * The SearchIndexFile class maps an index file written by
+ * writeSearchIndex() read-only into memory. Opening it checks the
+ * header (magic, version, checksum, section bounds) and nothing else, so
+ * it takes the same few microseconds for any number of keys; the keys
+ * are paged in by the first queries that touch them. Since the mapping
+ * is shared, every process serving the same index shares one copy in
+ * the page cache.
+ *
+ * verify() recomputes the payload checksum when a full integrity check
+ * is worth a pass over the file.
+ */
+
+class SearchIndexFile {
+ public:
+  // Maps the named index file. Throws std::runtime_error if it cannot be
+  // opened or is not a valid index.
+  explicit SearchIndexFile(const char* filename) : map_(nullptr), size_(0) {
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error(std::string("failed to open ") + filename);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t) sizeof(searchindex::Header)) {
+      size_ = st.st_size;
+      void* p = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+      map_ = p == MAP_FAILED ? nullptr : static_cast<const char*>(p);
+    }
+    close(fd);
+    const char* error = check();
+    if (error != nullptr) {
+      unmap();
+      throw std::runtime_error(std::string(filename) + ": " + error);
+    }
+  }
+
+  SearchIndexFile(const SearchIndexFile&) = delete;
+  SearchIndexFile& operator=(const SearchIndexFile&) = delete;
+
+  ~SearchIndexFile() { unmap(); }
+
+  // Returns true if the named file is a regular file that starts like an
+  // index file. Anything else, such as a pipe, is left unread, so it can
+  // still be opened as a text allowlist.
+  static bool isIndexFile(const char* filename) {
+    struct stat st;
+    if (stat(filename, &st) != 0 || !S_ISREG(st.st_mode)) {
+      return false;
+    }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    char magic[sizeof(searchindex::kMagic)];
+    bool is_index = read(fd, magic, sizeof(magic)) == (ssize_t) sizeof(magic) &&
+                    memcmp(magic, searchindex::kMagic, sizeof(magic)) == 0;
+    close(fd);
+    return is_index;
+  }
+
+  // Returns the number of keys.
+  size_t size() const { return header().count; }
+
+  // Returns the keys in ascending order.
+  const int* keys() const { return section(header().keys_offset); }
+
+  // Returns true if the file holds an Eytzinger layout of the keys.
+  bool hasEytzinger() const { return header().flags & searchindex::kHasEytzinger; }
+
+  // Returns a view of the stored Eytzinger layout; requires hasEytzinger().
+  EytzingerIndex eytzinger() const {
+    return EytzingerIndex(section(header().eytzinger_offset),
+                          section(header().rank_offset), size());
+  }
+
+  // Returns true if the payload matches the checksum in the header.
+  bool verify() const {
+    searchindex::Checksum c;
+    c.update(map_ + sizeof(searchindex::Header), size_ - sizeof(searchindex::Header));
+    return c.value() == header().payload_checksum;
+  }
+
+ private:
+  const searchindex::Header& header() const {
+    return *reinterpret_cast<const searchindex::Header*>(map_);
+  }
+
+  const int* section(uint64_t offset) const {
+    return reinterpret_cast<const int*>(map_ + offset);
+  }
+
+  // Returns what is wrong with the mapped header, or nullptr if it is valid.
+  const char* check() const {
+    using namespace searchindex;
+    if (map_ == nullptr) {
+      return "not an index file";
+    }
+    const Header& h = header();
+    if (memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) {
+      return "not an index file";
+    }
+    if (h.version != kVersion) {
+      return "unsupported index version";
+    }
+    if (h.header_checksum != headerChecksum(h)) {
+      return "corrupt index header";
+    }
+    uint64_t keys_end = alignUp(h.keys_offset + h.count * sizeof(int));
+    uint64_t end = keys_end;
+    if (h.flags & kHasEytzinger) {
+      if (h.eytzinger_offset < keys_end ||
+          h.rank_offset < h.eytzinger_offset + (h.count + 1) * sizeof(int)) {
+        return "corrupt index header";
+      }
+      end = alignUp(h.rank_offset + (h.count + 1) * sizeof(int));
+    }
+    if (h.count > 0x7fffffff || h.keys_offset % kAlign != 0 ||
+        h.eytzinger_offset % kAlign != 0 || h.rank_offset % kAlign != 0) {
+      return "corrupt index header";
+    }
+    if (end != size_) {
+      return "truncated index file";
+    }
+    return nullptr;
+  }
+
+  void unmap() {
+    if (map_ != nullptr) {
+      munmap(const_cast<char*>(map_), size_);
+      map_ = nullptr;
+    }
+  }
+
+ private:
+  const char* map_;   // the whole file, read-only
+  size_t size_;       // file size in bytes
+}; // class SearchIndexFile
+
+#endif // FUNDAMENTALS_SEARCH_INDEX_H_
@@ -0,0 +1,61 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 shardedUF.cc -o shardedUF
+ *  Execution:  ./shardedUF shards < input.txt
+ *  Dependencies: shardedUnionFind.h weightedQuickUnionPathCompressionUF.h
+ *                unionFind.h fastIO.h
+ *  Data files:   https://algs4.cs.princeton.edu/15uf/tinyUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/mediumUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/largeUF.txt
+ *
+ *  Reads n and pairs of elements from standard input, merges them in a
+ *  ShardedUnionFind with the given number of worker processes, and
+ *  prints the number of components and the hooking rounds it took. The
+ *  pairs are only sent to the shards, so unlike the other union-find
+ *  drivers it does not print the pairs that joined two components.
+ *
+ *  % ./shardedUF 4 < tinyUF.txt
+ *  2 components
+ *  4 shards, 2 rounds
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <string>
+
+#include "fastIO.h"
+#include "shardedUnionFind.h"
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s shards < input.txt\n", argv[0]);
+    return 1;
+  }
+  try {
+    int shards = std::stoi(argv[1]);
+    In in;
+    int n = in.readInt();
+    if (n < 0) {
+      throw std::invalid_argument("number of elements must be non-negative");
+    }
+    ShardedUnionFind uf(n, shards);
+    while (!in.isEmpty()) {
+      int p = in.readInt();
+      int q = in.readInt();
+      for (int x : { p, q }) {
+        if (x < 0 || x >= n) {
+          throw std::invalid_argument("index " + std::to_string(x) + " is not between 0 and " +
+                                      std::to_string(n - 1));
+        }
+      }
+      uf.merge(p, q);
+    }
+    printf("%zu components\n", uf.count());
+    printf("%d shards, %zu rounds\n", uf.shards(), uf.rounds());
+  } catch (const std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,517 @@
+/******************************************************************************
+ *  Header:       shardedUnionFind.h
+ *  Dependencies: weightedQuickUnionPathCompressionUF.h unionFind.h
+ *
+ *  Union-find split across worker processes, each owning a range of the
+ *  elements, exchanging pairs over Unix sockets and labels through
+ *  shared memory.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_SHARDED_UNION_FIND_H_
+#define FUNDAMENTALS_SHARDED_UNION_FIND_H_
+
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "weightedQuickUnionPathCompressionUF.h"
+
+namespace sharded {
+
+// The labels are shared between processes as an array of atomics, which
+// only works if they are lock-free.
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "labels must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "labels must be 32-bit");
+
+// What the coordinator asks of a worker; every command but kExit is
+// answered with one Message.
+enum Command : uint32_t {
+  kPairs,    // count pairs follow, each with its first element owned here
+  kPrepare,  // pairs are over: set up the labels and publish them
+  kHook,     // one round of hooking and shortcutting; reply count = changed
+  kPublish,  // write the labels of the owned elements to shared memory
+  kExit
+};
+
+struct Message {
+  uint32_t command;
+  uint32_t count;
+};
+
+// Reads or writes exactly n bytes of socket fd; returns false on failure
+// or end of file. Writing to a closed socket fails rather than raising
+// SIGPIPE.
+inline bool readAll(int fd, void* data, size_t n) {
+  char* p = static_cast<char*>(data);
+  while (n > 0) {
+    ssize_t got = read(fd, p, n);
+    if (got < 0 && errno == EINTR) {
+      continue;
+    }
+    if (got <= 0) {
+      return false;
+    }
+    p += got;
+    n -= got;
+  }
+  return true;
+}
+
+inline bool writeAll(int fd, const void* data, size_t n) {
+  const char* p = static_cast<const char*>(data);
+  while (n > 0) {
+    ssize_t written = send(fd, p, n, MSG_NOSIGNAL);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    p += written;
+    n -= written;
+  }
+  return true;
+}
+
+// Lowers *a to x if x is smaller; returns true if it did.
+inline bool lower(std::atomic<uint32_t>* a, uint32_t x) {
+  uint32_t old = a->load(std::memory_order_relaxed);
+  while (x < old) {
+    if (a->compare_exchange_weak(old, x, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// The state and message loop of the worker process owning the elements
+// [lo, hi) of n; label points at the shared array of n labels.
+class Worker {
+ public:
+  Worker(int fd, uint32_t lo, uint32_t hi, std::atomic<uint32_t>* label)
+      : fd_(fd), lo_(lo), hi_(hi), label_(label), uf_(hi - lo), dirty_(true) { }
+
+  // Serves commands until kExit; returns false if the coordinator is gone.
+  bool serve() {
+    std::vector<uint32_t> pairs;
+    Message m;
+    while (readAll(fd_, &m, sizeof(m))) {
+      uint32_t reply = 0;
+      switch (m.command) {
+        case kPairs:
+          pairs.resize(2 * size_t(m.count));
+          if (!readAll(fd_, pairs.data(), pairs.size() * sizeof(uint32_t))) {
+            return false;
+          }
+          add(pairs.data(), m.count);
+          continue;
+        case kPrepare:
+          prepare();
+          break;
+        case kHook:
+          reply = hook();
+          break;
+        case kPublish:
+          publish();
+          break;
+        default:
+          return true;
+      }
+      // the labels written above must be visible before the reply is
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      Message done = { m.command, reply };
+      if (!writeAll(fd_, &done, sizeof(done))) {
+        return false;
+      }
+    }
+    return false;
+  }
+
+ private:
+  // Merges the pairs within the range and keeps the others, which cross
+  // into another shard, for hooking.
+  void add(const uint32_t* pairs, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      uint32_t p = pairs[2 * i] - lo_;
+      uint32_t q = pairs[2 * i + 1];
+      if (q >= lo_ && q < hi_) {
+        uf_.merge(p, q - lo_);
+      } else {
+        cross_.push_back(std::make_pair(p, q));
+      }
+    }
+    dirty_ = true;
+  }
+
+  // Makes the smallest element of each local set its representative,
+  // labels every element with it, and turns the crossing pairs into
+  // distinct (representative, remote element) hooks.
+  void prepare() {
+    size_t n = hi_ - lo_;
+    if (dirty_) {
+      rep_.assign(n, std::numeric_limits<uint32_t>::max());
+      for (size_t v = 0; v < n; v++) {
+        uint32_t r = uf_.find(static_cast<uint32_t>(v));
+        rep_[r] = std::min(rep_[r], static_cast<uint32_t>(lo_ + v));
+      }
+      reps_.clear();
+      for (size_t v = 0; v < n; v++) {
+        rep_[v] = rep_[uf_.find(static_cast<uint32_t>(v))];
+        if (rep_[v] == lo_ + v) {
+          reps_.push_back(rep_[v]);
+        }
+      }
+      hooks_.resize(cross_.size());
+      for (size_t i = 0; i < cross_.size(); i++) {
+        hooks_[i] = std::make_pair(rep_[cross_[i].first], cross_[i].second);
+      }
+      std::sort(hooks_.begin(), hooks_.end());
+      hooks_.erase(std::unique(hooks_.begin(), hooks_.end()), hooks_.end());
+      dirty_ = false;
+    }
+    for (size_t v = 0; v < n; v++) {
+      label_[lo_ + v].store(rep_[v], std::memory_order_relaxed);
+    }
+  }
+
+  // For each hook, hangs the tree with the larger label under the
+  // smaller label, by lowering the label of the larger label; then
+  // shortcuts each representative to the label of its label. Returns
+  // the number of labels lowered.
+  uint32_t hook() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint32_t changed = 0;
+    for (const auto& h : hooks_) {
+      uint32_t a = label_[h.first].load(std::memory_order_relaxed);
+      uint32_t b = label_[h.second].load(std::memory_order_relaxed);
+      if (a < b) {
+        changed += lower(&label_[b], a);
+      } else if (b < a) {
+        changed += lower(&label_[a], b);
+      }
+    }
+    for (uint32_t r : reps_) {
+      uint32_t x = label_[r].load(std::memory_order_relaxed);
+      changed += lower(&label_[r], label_[x].load(std::memory_order_relaxed));
+    }
+    return changed;
+  }
+
+  // Labels every element that is not a representative with the label of
+  // its representative.
+  void publish() {
+    for (size_t v = 0; v < rep_.size(); v++) {
+      if (rep_[v] != lo_ + v) {
+        label_[lo_ + v].store(label_[rep_[v]].load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+      }
+    }
+  }
+
+  int fd_;
+  uint32_t lo_;
+  uint32_t hi_;
+  std::atomic<uint32_t>* label_;                       // shared, n labels
+  WeightedQuickUnionPathCompressionUF uf_;             // the local sets
+  std::vector<std::pair<uint32_t, uint32_t>> cross_;   // (local, remote) pairs
+  std::vector<std::pair<uint32_t, uint32_t>> hooks_;   // (representative, remote)
+  std::vector<uint32_t> rep_;                          // representative of each
+  std::vector<uint32_t> reps_;                         // the representatives
+  bool dirty_;                                         // pairs since prepare
+}; // class Worker
+
+} // namespace sharded
+
+ /**
+  * The ShardedUnionFind class splits a union-find on the elements 0
+  * through n - 1 across worker processes, one per shard, each owning a
+  * contiguous range of the elements and keeping its own
+  * WeightedQuickUnionPathCompressionUF on them; the calling process only
+  * coordinates.
+  *
+  * merge() does not wait for anything: the coordinator sends each pair,
+  * in batches over a Unix socket, to the shard owning its first element,
+  * and to the shard owning the second too if that is another one. A
+  * shard merges the pairs within its range at once and keeps the others.
+  *
+  * The first query after merges then labels every element with the
+  * smallest element of its set, in rounds of hooking and shortcutting
+  * (as in the parallel algorithm of Shiloach and Vishkin) on a shared
+  * array of labels, in which the label of a local set's smallest
+  * element, its representative, acts as its parent:
+  *
+  *   - each shard labels every element with its representative;
+  *   - in a round, for each pair crossing shards, the set whose label
+  *     is larger is hung under the other: the label of that label is
+  *     lowered, with an atomic compare-and-swap since other shards may
+  *     lower it too. Then each representative shortcuts to the label of
+  *     its label, and once all shards are done each relabels its other
+  *     elements with the label of their representative;
+  *   - the rounds stop at the first one in which no label changes.
+  *
+  * Labels only decrease and always name an element of the same set, so
+  * when none changes every element carries the smallest element of its
+  * set: the same answer, element for element, for any number of shards
+  * and any order of the pairs. Hooking whole trees and shortcutting
+  * keep the number of rounds small, about logarithmic in the size of the
+  * sets in practice.
+  *
+  * The processes are forked by the constructor, which is only safe
+  * while no other thread is running, and are stopped by the destructor.
+  * A query after merges takes theta(n / shards) time per shard and round
+  * plus the hooks; a query without new merges takes constant time.
+  */
+
+class ShardedUnionFind {
+ public:
+  // Initializes n elements, each in its own set, split over the given
+  // number of worker processes. Throws std::invalid_argument if shards
+  // is not positive or n needs more than 32 bits, and std::runtime_error
+  // if the processes cannot be started.
+  ShardedUnionFind(size_t n, int shards)
+      : n_(n), shards_(shards), label_(nullptr), count_(n), dirty_(false), rounds_(0) {
+    if (shards < 1) {
+      throw std::invalid_argument("at least one shard is needed");
+    }
+    if (n >= std::numeric_limits<uint32_t>::max()) {
+      throw std::invalid_argument("too many elements for 32-bit labels");
+    }
+    bound_.resize(shards + 1);
+    for (int s = 0; s <= shards; s++) {
+      bound_[s] = static_cast<uint32_t>(n * s / shards);
+    }
+    size_t bytes = std::max<size_t>(n, 1) * sizeof(uint32_t);
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      throw std::runtime_error("failed to map the shared labels");
+    }
+    label_ = static_cast<std::atomic<uint32_t>*>(p);
+    for (size_t i = 0; i < n; i++) {
+      new (&label_[i]) std::atomic<uint32_t>(static_cast<uint32_t>(i));
+    }
+    buffer_.resize(shards);
+    try {
+      for (int s = 0; s < shards; s++) {
+        start(s);
+      }
+    } catch (...) {
+      stop();
+      throw;
+    }
+  }
+
+  ShardedUnionFind(const ShardedUnionFind&) = delete;
+  ShardedUnionFind& operator=(const ShardedUnionFind&) = delete;
+
+  ~ShardedUnionFind() { stop(); }
+
+  // Returns the number of elements.
+  size_t size() const { return n_; }
+
+  // Returns the number of shards.
+  int shards() const { return shards_; }
+
+  // Merges the set containing element p with the set containing element
+  // q, eventually. Throws std::invalid_argument unless both are in range.
+  void merge(uint32_t p, uint32_t q) {
+    validate(p);
+    validate(q);
+    int sp = owner(p);
+    int sq = owner(q);
+    push(sp, p, q);
+    if (sq != sp) {
+      push(sq, q, p);
+    }
+    dirty_ = true;
+  }
+
+  // Returns the smallest element of the set containing element p.
+  uint32_t find(uint32_t p) {
+    validate(p);
+    solve();
+    return label_[p].load(std::memory_order_relaxed);
+  }
+
+  // Returns true if p and q are in the same set.
+  bool connected(uint32_t p, uint32_t q) { return find(p) == find(q); }
+
+  // Returns the number of sets.
+  size_t count() {
+    solve();
+    return count_;
+  }
+
+  // Returns the labels of all the elements: labels()[p] == find(p).
+  std::vector<uint32_t> labels() {
+    solve();
+    std::vector<uint32_t> all(n_);
+    for (size_t i = 0; i < n_; i++) {
+      all[i] = label_[i].load(std::memory_order_relaxed);
+    }
+    return all;
+  }
+
+  // Returns the number of hooking rounds the last query after merges ran.
+  size_t rounds() const { return rounds_; }
+
+ private:
+  static const size_t kBatch = 1 << 14;  // pairs per kPairs message
+
+  struct Shard {
+    pid_t pid;
+    int fd;
+  };
+
+  void validate(uint32_t p) const {
+    if (p >= n_) {
+      throw std::invalid_argument("index " + std::to_string(p) + " is not between 0 and " +
+                                  std::to_string(n_ - 1));
+    }
+  }
+
+  int owner(uint32_t p) const {
+    return static_cast<int>(std::upper_bound(bound_.begin(), bound_.end(), p) - bound_.begin()) - 1;
+  }
+
+  // Forks the worker of shard s, connected by a socket pair.
+  void start(int s) {
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+      throw std::runtime_error("failed to create a socket for shard " + std::to_string(s));
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+      close(fds[0]);
+      close(fds[1]);
+      throw std::runtime_error("failed to fork shard " + std::to_string(s));
+    }
+    if (pid == 0) {
+      close(fds[0]);
+      for (const Shard& other : shard_) {
+        close(other.fd);
+      }
+      bool ok = false;
+      try {
+        sharded::Worker worker(fds[1], bound_[s], bound_[s + 1], label_);
+        ok = worker.serve();
+      } catch (...) {
+      }
+      _exit(ok ? 0 : 1);
+    }
+    close(fds[1]);
+    shard_.push_back(Shard{ pid, fds[0] });
+  }
+
+  // Asks every worker to exit and waits for them.
+  void stop() {
+    for (const Shard& s : shard_) {
+      sharded::Message m = { sharded::kExit, 0 };
+      sharded::writeAll(s.fd, &m, sizeof(m));
+      close(s.fd);
+    }
+    for (const Shard& s : shard_) {
+      int status;
+      while (waitpid(s.pid, &status, 0) < 0 && errno == EINTR) { }
+    }
+    shard_.clear();
+    if (label_ != nullptr) {
+      munmap(label_, std::max<size_t>(n_, 1) * sizeof(uint32_t));
+      label_ = nullptr;
+    }
+  }
+
+  void push(int s, uint32_t p, uint32_t q) {
+    std::vector<uint32_t>& b = buffer_[s];
+    b.push_back(p);
+    b.push_back(q);
+    if (b.size() == 2 * kBatch) {
+      flush(s);
+    }
+  }
+
+  void flush(int s) {
+    std::vector<uint32_t>& b = buffer_[s];
+    if (b.empty()) {
+      return;
+    }
+    sharded::Message m = { sharded::kPairs, static_cast<uint32_t>(b.size() / 2) };
+    if (!sharded::writeAll(shard_[s].fd, &m, sizeof(m)) ||
+        !sharded::writeAll(shard_[s].fd, b.data(), b.size() * sizeof(uint32_t))) {
+      throw std::runtime_error("lost shard " + std::to_string(s));
+    }
+    b.clear();
+  }
+
+  // Sends command to every worker, then waits for every reply; returns
+  // the sum of the reply counts.
+  size_t broadcast(uint32_t command) {
+    for (int s = 0; s < shards_; s++) {
+      sharded::Message m = { command, 0 };
+      if (!sharded::writeAll(shard_[s].fd, &m, sizeof(m))) {
+        throw std::runtime_error("lost shard " + std::to_string(s));
+      }
+    }
+    size_t total = 0;
+    for (int s = 0; s < shards_; s++) {
+      sharded::Message reply;
+      if (!sharded::readAll(shard_[s].fd, &reply, sizeof(reply))) {
+        throw std::runtime_error("lost shard " + std::to_string(s));
+      }
+      total += reply.count;
+    }
+    // the replies tell that the labels are written; read them after
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return total;
+  }
+
+  // Runs the hooking rounds if there were merges since the last query.
+  void solve() {
+    if (!dirty_) {
+      return;
+    }
+    for (int s = 0; s < shards_; s++) {
+      flush(s);
+    }
+    broadcast(sharded::kPrepare);
+    rounds_ = 0;
+    for (;;) {
+      rounds_++;
+      if (broadcast(sharded::kHook) == 0) {
+        break;
+      }
+      broadcast(sharded::kPublish);
+    }
+    count_ = 0;
+    for (size_t i = 0; i < n_; i++) {
+      count_ += label_[i].load(std::memory_order_relaxed) == i;
+    }
+    dirty_ = false;
+  }
+
+  size_t n_;                                   // number of elements
+  int shards_;                                 // number of workers
+  std::vector<uint32_t> bound_;                // shard s owns [bound_[s], bound_[s + 1])
+  std::vector<Shard> shard_;                   // the workers
+  std::vector<std::vector<uint32_t>> buffer_;  // pairs not sent yet, per shard
+  std::atomic<uint32_t>* label_;               // shared, n labels
+  size_t count_;                               // number of sets, when solved
+  bool dirty_;                                 // merges since the last query
+  size_t rounds_;                              // rounds of the last query
+}; // class ShardedUnionFind
+
+#endif // FUNDAMENTALS_SHARDED_UNION_FIND_H_
@@ -0,0 +1,109 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 shardedUnionFindBench.cc -o shardedUnionFindBench
+ *  Execution:  ./shardedUnionFindBench [n]
+ *  Dependencies: shardedUnionFind.h weightedQuickUnionPathCompressionUF.h
+ *                unionFind.h workloads.h stopwatch.h
+ *
+ *  ShardedUnionFind on 1, 2, 4, 8 and 16 worker processes, against one
+ *  WeightedQuickUnionPathCompressionUF in this process, on workloads of
+ *  workloads.h at scale n (default 1M): the time to merge all the pairs
+ *  and label every element with the smallest element of its set, and the
+ *  hooking rounds that took. Every sharded labeling must equal the
+ *  single-process one, element for element.
+ *
+ *  % ./shardedUnionFindBench
+ *  workload       pairs      sets  1 process       1 shard      2 shards      4 shards      8 shards     16 shards
+ *  random        500000    500004     0.065s   0.088s  1r   0.201s  6r   0.282s  8r   0.304s  8r   0.316s  8r
+ *  random       2000000     19004     0.109s   0.167s  1r   0.601s  3r   0.882s  3r   0.981s  4r   1.069s  4r
+ *  grid          719388    425945     0.066s   0.096s  1r   0.105s  3r   0.111s  3r   0.147s  4r   0.139s  5r
+ *  powerlaw     2000000    488633     0.099s   0.185s  1r   0.466s  3r   0.730s  3r   0.760s  4r   0.912s  4r
+ *
+ *  (single-core machine, so the shards take turns and the columns show
+ *  the cost of sharding rather than its gain: routing every pair over a
+ *  socket, keeping and sorting the crossing ones, and the rounds. The
+ *  rounds stay at a handful from 2 to 16 shards)
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "shardedUnionFind.h"
+#include "stopwatch.h"
+#include "weightedQuickUnionPathCompressionUF.h"
+#include "workloads.h"
+
+// Labels every element with the smallest element of its set, in one
+// process.
+std::vector<uint32_t> singleProcess(const workload::UnionFindWorkload& w) {
+  WeightedQuickUnionPathCompressionUF uf(w.n);
+  for (const auto& p : w.pairs) {
+    uf.merge(p.first, p.second);
+  }
+  std::vector<uint32_t> smallest(w.n, std::numeric_limits<uint32_t>::max());
+  for (size_t v = 0; v < w.n; v++) {
+    uint32_t r = uf.find(static_cast<uint32_t>(v));
+    smallest[r] = std::min(smallest[r], static_cast<uint32_t>(v));
+  }
+  std::vector<uint32_t> label(w.n);
+  for (size_t v = 0; v < w.n; v++) {
+    label[v] = smallest[uf.find(static_cast<uint32_t>(v))];
+  }
+  return label;
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = argc > 1 ? std::stoull(argv[1]) : 1000000;
+  std::vector<workload::UnionFindWorkload> workloads;
+  workloads.push_back(workload::random(n, n / 2));
+  workloads.push_back(workload::random(n, 2 * n));
+  size_t side = 1;
+  while ((side + 1) * (side + 1) <= n) {
+    side++;
+  }
+  workloads.push_back(workload::grid(side));
+  workloads.push_back(workload::powerLaw(n, 2 * n));
+  const int kShards[] = { 1, 2, 4, 8, 16 };
+
+  printf("%-10s %9s %9s %10s", "workload", "pairs", "sets", "1 process");
+  for (int s : kShards) {
+    printf(" %13s", (std::to_string(s) + (s == 1 ? " shard" : " shards")).c_str());
+  }
+  printf("\n");
+  try {
+    for (const workload::UnionFindWorkload& w : workloads) {
+      Stopwatch single_timer;
+      std::vector<uint32_t> expected = singleProcess(w);
+      double single = single_timer.elapsedTime();
+      size_t sets = 0;
+      for (size_t v = 0; v < w.n; v++) {
+        sets += expected[v] == v;
+      }
+      printf("%-10s %9zu %9zu %9.3fs", w.name.c_str(), w.pairs.size(), sets, single);
+      for (int s : kShards) {
+        ShardedUnionFind uf(w.n, s);
+        Stopwatch timer;
+        for (const auto& p : w.pairs) {
+          uf.merge(p.first, p.second);
+        }
+        std::vector<uint32_t> label = uf.labels();
+        double elapsed = timer.elapsedTime();
+        if (label != expected) {
+          fprintf(stderr, "\n%s: %d shards disagree with one process\n", w.name.c_str(), s);
+          return 1;
+        }
+        printf(" %7.3fs %2zur", elapsed, uf.rounds());
+      }
+      printf("\n");
+    }
+  } catch (const std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,142 @@
+/******************************************************************************
+ *  Header:       simdSearch.h
+ *  Dependencies: bsearch.h
+ *
+ *  Binary search whose last levels compare the key against 16 sorted
+ *  elements at once with AVX2 or SSE2, selected at runtime by CPUID.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_SIMD_SEARCH_H_
+#define FUNDAMENTALS_SIMD_SEARCH_H_
+
+#include <cstddef>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_SEARCH_X86 1
+#endif
+
+#include "bsearch.h"
+
+namespace simdsearch {
+
+// Width of the window the final step scans in one go.
+const size_t kWindow = 16;
+
+// Narrows the search for the lower bound of key in a[0..n) to a window
+// of at most kWindow elements: on return every element before base is
+// < key and every element at or after base + len is >= key.
+// Branchless, so the only stalls are the cache misses themselves; the
+// two candidates for the next probe are prefetched one step ahead.
+inline const int* narrow(const int* base, size_t n, int key, size_t* len) {
+  while (n > kWindow) {
+    size_t half = n / 2;
+    __builtin_prefetch(base + half / 2);
+    __builtin_prefetch(base + half + half / 2);
+    base = base[half - 1] < key ? base + half : base;
+    n -= half;
+  }
+  *len = n;
+  return base;
+}
+
+// Counts the elements < key in w[0..kWindow), one at a time.
+inline int countLessScalar(const int* w, int key) {
+  int count = 0;
+  for (size_t i = 0; i < kWindow; i++) {
+    count += w[i] < key;
+  }
+  return count;
+}
+
+#ifdef SIMD_SEARCH_X86
+// Counts the elements < key in w[0..kWindow) with four 4-lane compares.
+__attribute__((target("sse2")))
+inline int countLessSse2(const int* w, int key) {
+  __m128i k = _mm_set1_epi32(key);
+  __m128i m0 = _mm_cmpgt_epi32(k, _mm_loadu_si128((const __m128i*) w));
+  __m128i m1 = _mm_cmpgt_epi32(k, _mm_loadu_si128((const __m128i*) (w + 4)));
+  __m128i m2 = _mm_cmpgt_epi32(k, _mm_loadu_si128((const __m128i*) (w + 8)));
+  __m128i m3 = _mm_cmpgt_epi32(k, _mm_loadu_si128((const __m128i*) (w + 12)));
+  __m128i lo = _mm_packs_epi32(m0, m1);
+  __m128i hi = _mm_packs_epi32(m2, m3);
+  return __builtin_popcount(_mm_movemask_epi8(_mm_packs_epi16(lo, hi)));
+}
+
+// Counts the elements < key in w[0..kWindow) with two 8-lane compares.
+__attribute__((target("avx2")))
+inline int countLessAvx2(const int* w, int key) {
+  __m256i k = _mm256_set1_epi32(key);
+  __m256i m0 = _mm256_cmpgt_epi32(k, _mm256_loadu_si256((const __m256i*) w));
+  __m256i m1 = _mm256_cmpgt_epi32(k, _mm256_loadu_si256((const __m256i*) (w + 8)));
+  int mask = _mm256_movemask_ps(_mm256_castsi256_ps(m0)) |
+             _mm256_movemask_ps(_mm256_castsi256_ps(m1)) << 8;
+  return __builtin_popcount(mask);
+}
+#endif
+
+// Returns the index of key in the sorted array a[0..n) if present;
+// -1 otherwise. CountLess is one of the kernels above.
+template <int (*CountLess)(const int*, int)>
+int search(const int* a, size_t n, int key) {
+  if (n < kWindow) {
+    return bsearch(a, n, key);
+  }
+  size_t len;
+  const int* base = narrow(a, n, key, &len);
+  // slide the window left if it would run past the end; the elements
+  // it picks up are all < key, so the count stays the lower bound
+  const int* w = base + kWindow <= a + n ? base : a + n - kWindow;
+  size_t i = w - a + CountLess(w, key);
+  return i < n && a[i] == key ? static_cast<int>(i) : -1;
+}
+
+// The kernels the CPU supports, best first.
+enum Level { kScalar, kSse2, kAvx2 };
+
+// Returns the best kernel level this CPU supports.
+inline Level detect() {
+#ifdef SIMD_SEARCH_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return kAvx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return kSse2;
+  }
+#endif
+  return kScalar;
+}
+
+typedef int (*SearchFn)(const int*, size_t, int);
+
+// Returns the search function for the given kernel level.
+inline SearchFn searchFor(Level level) {
+#ifdef SIMD_SEARCH_X86
+  if (level == kAvx2) {
+    return search<countLessAvx2>;
+  }
+  if (level == kSse2) {
+    return search<countLessSse2>;
+  }
+#endif
+  return search<countLessScalar>;
+}
+
+} // namespace simdsearch
+
+// Returns the index of the specified key in the specified sorted array
+// if present; -1 otherwise. Same contract as bsearch(), using the widest
+// compare kernel the CPU supports (chosen once, on first call).
+inline int bsearchSimd(const int* arr, size_t n, int key) {
+  static const simdsearch::SearchFn fn = simdsearch::searchFor(simdsearch::detect());
+  return fn(arr, n, key);
+}
+
+inline int bsearchSimd(const std::vector<int>& arr, int key) {
+  return bsearchSimd(arr.data(), arr.size(), key);
+}
+
+#endif // FUNDAMENTALS_SIMD_SEARCH_H_
@@ -0,0 +1,36 @@
+/******************************************************************************
+ *  Header:       stopwatch.h
+ *  Dependencies:
+ *
+ *  A utility class to measure the running time (wall clock) of a program.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_STOPWATCH_H_
+#define FUNDAMENTALS_STOPWATCH_H_
+
+#include <chrono>
+
+/**
+ * The Stopwatch data type is for measuring the time that elapses between
+ * the start and end of a programming task (wall-clock time).
+ *
+ * For additional documentation, see https://algs4.cs.princeton.edu/14analysis.
+ */
+
+class Stopwatch {
+ public:
+  // Initializes a new stopwatch.
+  Stopwatch() : start_(std::chrono::steady_clock::now()) { }
+
+  // Returns the elapsed time (in seconds) since the stopwatch was created.
+  double elapsedTime() const {
+    std::chrono::duration<double> d = std::chrono::steady_clock::now() - start_;
+    return d.count();
+  }
+
+ private:
+  std::chrono::steady_clock::time_point start_;
+}; // class Stopwatch
+
+#endif // FUNDAMENTALS_STOPWATCH_H_
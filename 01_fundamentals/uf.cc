@@ -0,0 +1,60 @@
+/******************************************************************************
+ *  Compilation:  g++ uf.cc -o uf
+ *  Execution:  ./uf < input.txt
+ *  Dependencies: unionFind.h unionFindClient.h fastIO.h opStats.h
+ *  Data files:   https://algs4.cs.princeton.edu/15uf/tinyUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/mediumUF.txt
+ *                https://algs4.cs.princeton.edu/15uf/largeUF.txt
+ *
+ *  Weighted quick-union by rank with path compression by halving.
+ *
+ *  % ./uf < tinyUF.txt
+ *  4 3
+ *  3 8
+ *  6 5
+ *  9 4
+ *  2 1
+ *  5 0
+ *  7 2
+ *  6 1
+ *  2 components
+ *
+ ******************************************************************************/
+
+#include <cstdint>
+
+#include "fastIO.h"
+#include "opStats.h"
+#include "unionFind.h"
+#include "unionFindClient.h"
+
+ /**
+  * The UF class represents a union-find data type
+  * (also known as the disjoint-sets data type).
+  *
+  * This implementation uses weighted quick union by rank
+  * with path compression by halving: the UnionFind defaults.
+  * Initializing a data structure with n sites takes linear time.
+  * Afterwards, the union and find operations take logarithmic time
+  * (in the worst case) and the count operation takes constant time.
+  * Moreover, starting from an empty data
+  * structure with n sites, any intermixed sequence of m union and
+  * find operations takes O(m alpha(n)) time.
+  *
+  * For additional documentation, see https://algs4.cs.princeton.edu/15uf.
+  */
+
+typedef UnionFind<uint32_t, uf::ByRank, uf::PathHalving, uf::Checked> UF;
+
+// Reads an integer n and a sequence of pairs of integers
+// (between 0 and n - 1 from standard input, where each integer)
+// in the pair represents some element;
+// if the elements are in different sets, merge the two sets
+// and print the pair to standard output.
+int main(int argc, char* argv[]) {
+  opstats::dumpJsonAtExit();
+  In in;
+  Out out;
+  unionFindBlockClient<UF>(in, out);
+  return out.exitStatus();
+}
@@ -0,0 +1,426 @@
+/******************************************************************************
+ *  Header:       unionFind.h
+ *  Dependencies: opStats.h
+ *
+ *  Policy-based union-find: the quick-union family in one template.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_UNION_FIND_H_
+#define FUNDAMENTALS_UNION_FIND_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "opStats.h"
+
+namespace uf {
+
+// Link policies: which of two roots merge() hangs below the other. Each
+// has a State<IndexT> holding whatever per-element data it needs, with
+// link(parent, a, b) linking the distinct roots a and b and returning
+// the root of the union, and prefetch(r) fetching the data of root r.
+
+// Always hangs the first root below the second (plain quick-union).
+struct Naive {
+  static const char* name() { return "naive"; }
+
+  template <typename IndexT>
+  struct State {
+    void init(size_t) { }
+    void prefetch(IndexT) const { }
+    IndexT link(IndexT* parent, IndexT a, IndexT b) {
+      parent[a] = b;
+      return b;
+    }
+  };
+};
+
+// Hangs the root of the smaller tree below the other; ties keep the
+// first. Tree height stays below log2(n).
+struct BySize {
+  static const char* name() { return "size"; }
+
+  template <typename IndexT>
+  struct State {
+    std::vector<IndexT> size;   // size[r] = number of elements under root r
+
+    void init(size_t n) { size.assign(n, 1); }
+    void prefetch(IndexT r) const { __builtin_prefetch(&size[r]); }
+    IndexT link(IndexT* parent, IndexT a, IndexT b) {
+      if (size[a] < size[b]) {
+        parent[a] = b;
+        size[b] += size[a];
+        return b;
+      }
+      parent[b] = a;
+      size[a] += size[b];
+      return a;
+    }
+  };
+};
+
+// Hangs the root of lower rank below the other, bumping the rank on a
+// tie. Same height bound as BySize with one byte per element.
+struct ByRank {
+  static const char* name() { return "rank"; }
+
+  template <typename IndexT>
+  struct State {
+    std::vector<uint8_t> rank;  // rank[r] = upper bound on the height of r
+
+    void init(size_t n) { rank.assign(n, 0); }
+    void prefetch(IndexT r) const { __builtin_prefetch(&rank[r]); }
+    IndexT link(IndexT* parent, IndexT a, IndexT b) {
+      if (rank[a] < rank[b]) {
+        parent[a] = b;
+        return b;
+      }
+      parent[b] = a;
+      rank[a] += rank[a] == rank[b];
+      return a;
+    }
+  };
+};
+
+// Compress policies: what find(parent, p) does to the path it walks.
+// Each reports the links it follows and rewrites to opstats.
+
+// Leaves the path alone.
+struct NoCompression {
+  static const char* name() { return "none"; }
+
+  template <typename IndexT>
+  static IndexT find(IndexT* parent, IndexT p) {
+    opstats::Sample sample(opstats::kFindNanos);
+    uint64_t hops = 0;
+    while (p != parent[p]) {
+      p = parent[p];
+      hops++;
+    }
+    opstats::record(opstats::kFindHops, hops);
+    opstats::record(opstats::kFindWrites, 0);
+    return p;
+  }
+};
+
+// Points every node on the path at the root, in a second pass.
+struct FullCompression {
+  static const char* name() { return "full"; }
+
+  template <typename IndexT>
+  static IndexT find(IndexT* parent, IndexT p) {
+    opstats::Sample sample(opstats::kFindNanos);
+    uint64_t hops = 0;
+    IndexT root = p;
+    while (root != parent[root]) {
+      root = parent[root];
+      hops++;
+    }
+    uint64_t writes = 0;
+    while (p != root) {
+      IndexT next = parent[p];
+      writes += next != root;
+      parent[p] = root;
+      p = next;
+    }
+    opstats::record(opstats::kFindHops, hops);
+    opstats::record(opstats::kFindWrites, writes);
+    return root;
+  }
+};
+
+// Points every other node on the path at its grandparent, in one pass.
+struct PathHalving {
+  static const char* name() { return "halving"; }
+
+  template <typename IndexT>
+  static IndexT find(IndexT* parent, IndexT p) {
+    opstats::Sample sample(opstats::kFindNanos);
+    uint64_t hops = 0;
+    uint64_t writes = 0;
+    while (p != parent[p]) {
+      IndexT next = parent[p];
+      writes += parent[next] != next;
+      parent[p] = parent[next];
+      p = parent[p];
+      hops++;
+    }
+    opstats::record(opstats::kFindHops, hops);
+    opstats::record(opstats::kFindWrites, writes);
+    return p;
+  }
+};
+
+// Points every node on the path at its grandparent, in one pass.
+struct PathSplitting {
+  static const char* name() { return "splitting"; }
+
+  template <typename IndexT>
+  static IndexT find(IndexT* parent, IndexT p) {
+    opstats::Sample sample(opstats::kFindNanos);
+    uint64_t hops = 0;
+    uint64_t writes = 0;
+    while (p != parent[p]) {
+      IndexT next = parent[p];
+      writes += parent[next] != next;
+      parent[p] = parent[next];
+      p = next;
+      hops++;
+    }
+    opstats::record(opstats::kFindHops, hops);
+    opstats::record(opstats::kFindWrites, writes);
+    return p;
+  }
+};
+
+// Check policies: what an index outside [0, n) does.
+
+// Throws std::out_of_range.
+struct Checked {
+  static const char* name() { return "checked"; }
+  static const bool kThrows = true;
+
+  template <typename IndexT>
+  static void validate(IndexT p, size_t n) {
+    if (p >= n) {
+      // print negative ints that wrapped around as what they were
+      char msg[80];
+      snprintf(msg, sizeof(msg), "index %lld is not between 0 and %lld",
+               static_cast<long long>(static_cast<typename std::make_signed<IndexT>::type>(p)),
+               static_cast<long long>(n) - 1);
+      throw std::out_of_range(msg);
+    }
+  }
+};
+
+// Trusts the caller: undefined behavior, no code.
+struct Unchecked {
+  static const char* name() { return "unchecked"; }
+  static const bool kThrows = false;
+
+  template <typename IndexT>
+  static void validate(IndexT, size_t) noexcept { }
+};
+
+// Returns the height of the tallest tree of a forest on the elements
+// 0 through n - 1, where parent(i) is the parent of i or i itself for a
+// root: the most links a find can have to follow. Each depth is worked
+// out once, so this takes theta(n) time and n extra words.
+template <typename ParentFn>
+size_t height(size_t n, ParentFn parent) {
+  const uint32_t kUnknown = ~uint32_t(0);
+  std::vector<uint32_t> depth(n, kUnknown);
+  std::vector<size_t> path;
+  uint32_t tallest = 0;
+  for (size_t i = 0; i < n; i++) {
+    size_t p = i;
+    while (depth[p] == kUnknown) {
+      size_t next = parent(p);
+      if (next == p) {
+        depth[p] = 0;
+        break;
+      }
+      path.push_back(p);
+      p = next;
+    }
+    uint32_t d = depth[p];
+    while (!path.empty()) {
+      depth[path.back()] = ++d;
+      path.pop_back();
+    }
+    tallest = std::max(tallest, d);
+  }
+  return tallest;
+}
+
+// Batches: find and merge on many elements at once.
+
+// A lone find waits out one cache miss per hop, since each parent is only
+// known once the previous load completes. The batch operations run a
+// software pipeline instead: kPrefetchLevels strides of kPrefetchStride
+// elements ahead of the one being processed, an element gets its first
+// parent slot prefetched; one stride later, that slot is in cache and
+// the next hop is prefetched; and so on, so that by its turn the first
+// kPrefetchLevels hops of its path (which, with compression, is most of
+// it) are cached, and the misses of different elements overlap.
+const size_t kPrefetchLevels = 3;
+const size_t kPrefetchStride = 8;
+
+// Follows hops parent links up from p, stopping at a root, prefetches
+// the parent slot reached and returns it. p outside [0, n) is ignored.
+template <typename IndexT>
+inline IndexT prefetchHop(const IndexT* parent, size_t n, IndexT p, size_t hops) {
+  if (p >= n) {
+    return 0;
+  }
+  for (size_t h = 0; h < hops; h++) {
+    p = parent[p];
+  }
+  __builtin_prefetch(&parent[p]);
+  return p;
+}
+
+} // namespace uf
+
+ /**
+  * The UnionFind class template represents a union-find data type
+  * (also known as the disjoint-sets data type) on the elements 0 through
+  * n - 1, with the quick-union representation: each element points at a
+  * parent, and the roots are the canonical elements of the sets.
+  *
+  * The policies, fixed at compile time, choose the variant:
+  *
+  *   - IndexT          unsigned element type, uint32_t or uint64_t
+  *   - LinkPolicy      uf::Naive, uf::BySize or uf::ByRank
+  *   - CompressPolicy  uf::NoCompression, uf::FullCompression,
+  *                     uf::PathHalving or uf::PathSplitting
+  *   - CheckPolicy     uf::Checked or uf::Unchecked
+  *
+  * Everything is inlined into find and merge, and with uf::Unchecked they
+  * are noexcept and contain no exception handling code at all.
+  *
+  * With a weighted link policy find and merge take O(log n) time in the
+  * worst case; adding any of the compressions brings a sequence of m
+  * operations down to O(m alpha(n)), where alpha(n) is the inverse of
+  * https://en.wikipedia.org/wiki/Ackermann_function#Inverse.
+  * The constructor takes theta(n) time; count takes theta(1) time.
+  *
+  * For additional documentation, see https://algs4.cs.princeton.edu/15uf.
+  */
+
+template <typename IndexT = uint32_t,
+          typename LinkPolicy = uf::ByRank,
+          typename CompressPolicy = uf::PathHalving,
+          typename CheckPolicy = uf::Checked>
+class UnionFind {
+  static_assert(std::is_unsigned<IndexT>::value, "IndexT must be an unsigned integer");
+
+ public:
+  typedef IndexT Index;
+  static const bool kNoexcept = !CheckPolicy::kThrows;
+
+  // Initializes an empty union-find data structure with n elements
+  // 0 through n - 1. Initially, each element is in its own set.
+  explicit UnionFind(size_t n) : parent_(n), count_(n) {
+    for (size_t i = 0; i < n; i++) {
+      parent_[i] = static_cast<IndexT>(i);
+    }
+    link_.init(n);
+  }
+
+  // Returns the number of elements.
+  size_t size() const { return parent_.size(); }
+
+  // Returns the number of sets.
+  IndexT count() const { return count_; }
+
+  // Returns the canonical element of the set containing element p.
+  IndexT find(IndexT p) noexcept(kNoexcept) {
+    CheckPolicy::validate(p, parent_.size());
+    return CompressPolicy::find(parent_.data(), p);
+  }
+
+  // Returns true if p and q are in the same set.
+  bool connected(IndexT p, IndexT q) noexcept(kNoexcept) {
+    return find(p) == find(q);
+  }
+
+  // Merges the set containing element p with the set containing element
+  // q; returns false if they were already the same set.
+  bool merge(IndexT p, IndexT q) noexcept(kNoexcept) {
+    opstats::Sample sample(opstats::kMergeNanos);
+    IndexT root_p = find(p);
+    IndexT root_q = find(q);
+    if (root_p == root_q) {
+      return false;
+    }
+    link_.link(parent_.data(), root_p, root_q);
+    count_--;
+    return true;
+  }
+
+  // Links the distinct roots a and b, as merge would, and returns the
+  // root of the union: merge for callers that already know the roots.
+  IndexT mergeRoots(IndexT a, IndexT b) noexcept {
+    count_--;
+    return link_.link(parent_.data(), a, b);
+  }
+
+  // Prefetches the parent slot of element p, in range, into the cache.
+  void prefetch(IndexT p) const noexcept { __builtin_prefetch(&parent_[p]); }
+
+  // Puts every element back in its own set, reusing the storage.
+  void reset() {
+    for (size_t i = 0; i < parent_.size(); i++) {
+      parent_[i] = static_cast<IndexT>(i);
+    }
+    link_.init(parent_.size());
+    count_ = static_cast<IndexT>(parent_.size());
+  }
+
+  // Returns the height of the tallest tree; see uf::height.
+  size_t height() const {
+    return uf::height(parent_.size(), [this](size_t i) { return parent_[i]; });
+  }
+
+  // Stores find(ids[i]) in roots[i] for every i in [0, count). Same
+  // result as calling find for each, with the path walks of successive
+  // ids overlapped by prefetching (see uf::kPrefetchLevels).
+  void findBatch(const IndexT* ids, size_t count, IndexT* roots) noexcept(kNoexcept) {
+    const IndexT* parent = parent_.data();
+    for (size_t i = 0; i < count; i++) {
+      for (size_t level = 0; level < uf::kPrefetchLevels; level++) {
+        size_t ahead = i + (uf::kPrefetchLevels - level) * uf::kPrefetchStride;
+        if (ahead < count) {
+          uf::prefetchHop(parent, parent_.size(), ids[ahead], level);
+        }
+      }
+      roots[i] = find(ids[i]);
+    }
+  }
+
+  // Merges the pairs (pairs[2i], pairs[2i + 1]) for i in [0, count), in
+  // order, and returns how many of them joined two sets; if merged is not
+  // null, merged[i] tells whether pair i did. Same result as calling merge
+  // for each pair, with the walks overlapped as in findBatch and the link
+  // data (size or rank) near the roots prefetched too. If an element is
+  // out of range the pairs before it are merged and the exception thrown.
+  size_t mergeBatch(const IndexT* pairs, size_t count, bool* merged = nullptr)
+      noexcept(kNoexcept) {
+    const IndexT* parent = parent_.data();
+    const size_t last = uf::kPrefetchLevels - 1;
+    size_t joined = 0;
+    for (size_t i = 0; i < count; i++) {
+      for (size_t level = 0; level < uf::kPrefetchLevels; level++) {
+        size_t ahead = i + (uf::kPrefetchLevels - level) * uf::kPrefetchStride;
+        if (ahead < count) {
+          IndexT p = uf::prefetchHop(parent, parent_.size(), pairs[2 * ahead], level);
+          IndexT q = uf::prefetchHop(parent, parent_.size(), pairs[2 * ahead + 1], level);
+          if (level == last) {
+            link_.prefetch(p);
+            link_.prefetch(q);
+          }
+        }
+      }
+      bool m = merge(pairs[2 * i], pairs[2 * i + 1]);
+      if (merged != nullptr) {
+        merged[i] = m;
+      }
+      joined += m;
+    }
+    return joined;
+  }
+
+ private:
+  std::vector<IndexT> parent_;                        // parent_[i] = parent of i
+  typename LinkPolicy::template State<IndexT> link_;  // size or rank, if any
+  IndexT count_;                                      // number of components
+}; // class UnionFind
+
+#endif // FUNDAMENTALS_UNION_FIND_H_
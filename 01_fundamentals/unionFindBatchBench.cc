@@ -0,0 +1,120 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 unionFindBatchBench.cc -o unionFindBatchBench
+ *  Execution:  ./unionFindBatchBench input.txt
+ *              ./unionFindBatchBench n [m]
+ *  Dependencies: unionFind.h fastIO.h stopwatch.h workloads.h
+ *  Data files:   https://algs4.cs.princeton.edu/15uf/largeUF.txt
+ *
+ *  UnionFind::mergeBatch and findBatch against merge and find called
+ *  one at a time, for a few policy combinations: the pairs of a
+ *  union-find input file, or m random pairs over n elements (m defaults
+ *  to n), are merged, and then m random elements are looked up.
+ *
+ *  % ./unionFindBatchBench largeUF.txt
+ *  1000000 elements, 2000000 pairs           Mmerge/s               Mfind/s
+ *  link   compress        one    batch             one    batch
+ *  naive  halving         9.7      9.7  1.00x     86.7     90.5  1.04x
+ *  size   none           15.8     19.9  1.26x     38.2     37.6  0.98x
+ *  size   full           24.5     31.7  1.29x    123.0    117.6  0.96x
+ *  size   halving        31.0     50.1  1.62x    131.4    134.1  1.02x
+ *  rank   halving        38.3     42.5  1.11x    114.9    123.2  1.07x
+ *
+ *  % ./unionFindBatchBench 50000000
+ *  50000000 elements, 50000000 pairs           Mmerge/s               Mfind/s
+ *  link   compress        one    batch             one    batch
+ *  naive  halving         2.1      2.1  0.98x     23.0     25.9  1.12x
+ *  size   none            6.4     12.0  1.86x     15.9     16.5  1.04x
+ *  size   full            6.7     15.3  2.30x     28.6     28.5  1.00x
+ *  size   halving         7.5     13.4  1.79x     30.3     34.8  1.15x
+ *  rank   halving         7.6     14.9  1.95x     34.5     29.2  0.85x
+ *
+ *  (single-core machine with a 300 MB last-level cache, timings vary by
+ *  about 10% between runs: largeUF's 8 MB of arrays sit in cache, and
+ *  batching gains 10-60%; at 50M elements every first hop misses and
+ *  mergeBatch runs about twice as fast. The finds after the merges walk
+ *  short, compressed, independent paths that out-of-order execution
+ *  already overlaps, so findBatch gains little there)
+ *
+ ******************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "fastIO.h"
+#include "stopwatch.h"
+#include "unionFind.h"
+#include "workloads.h"
+
+template <typename Link, typename Compress>
+void run(size_t n, const std::vector<uint32_t>& pairs, const std::vector<uint32_t>& queries) {
+  typedef UnionFind<uint32_t, Link, Compress, uf::Unchecked> UF;
+  size_t m = pairs.size() / 2;
+  std::vector<uint32_t> roots(queries.size());
+
+  UF one(n);
+  Stopwatch merge_timer;
+  for (size_t i = 0; i < m; i++) {
+    one.merge(pairs[2 * i], pairs[2 * i + 1]);
+  }
+  double merge_one = merge_timer.elapsedTime();
+  Stopwatch find_timer;
+  for (size_t i = 0; i < queries.size(); i++) {
+    roots[i] = one.find(queries[i]);
+  }
+  double find_one = find_timer.elapsedTime();
+
+  UF batch(n);
+  Stopwatch merge_batch_timer;
+  batch.mergeBatch(pairs.data(), m);
+  double merge_batch = merge_batch_timer.elapsedTime();
+  Stopwatch find_batch_timer;
+  batch.findBatch(queries.data(), queries.size(), roots.data());
+  double find_batch = find_batch_timer.elapsedTime();
+
+  printf("%-6s %-10s %8.1f %8.1f %5.2fx %8.1f %8.1f %5.2fx  %s\n", Link::name(),
+         Compress::name(), m / merge_one / 1e6, m / merge_batch / 1e6, merge_one / merge_batch,
+         queries.size() / find_one / 1e6, queries.size() / find_batch / 1e6,
+         find_one / find_batch, one.count() == batch.count() ? "" : "COUNTS DIFFER");
+}
+
+int main(int argc, char* argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s input.txt | n [m]\n", argv[0]);
+    return 1;
+  }
+  size_t n;
+  std::vector<uint32_t> pairs;
+  char* end;
+  n = strtoull(argv[1], &end, 10);
+  if (*end == '\0' && n > 0) {
+    size_t m = argc > 2 ? std::stoull(argv[2]) : n;
+    pairs.resize(2 * m);
+    for (size_t i = 0; i < 2 * m; i++) {
+      pairs[i] = workload::below(workload::mix(0, i), n);
+    }
+  } else {
+    In in(argv[1]);
+    n = in.readInt();
+    while (!in.isEmpty()) {
+      pairs.push_back(in.readInt());
+    }
+  }
+  std::vector<uint32_t> queries(pairs.size() / 2);
+  for (size_t i = 0; i < queries.size(); i++) {
+    queries[i] = workload::below(workload::mix(0, ~i), n);
+  }
+
+  printf("%zu elements, %zu pairs           Mmerge/s               Mfind/s\n", n,
+         pairs.size() / 2);
+  printf("%-6s %-10s %8s %8s %6s %8s %8s %6s\n", "link", "compress", "one", "batch", "",
+         "one", "batch", "");
+  run<uf::Naive, uf::PathHalving>(n, pairs, queries);
+  run<uf::BySize, uf::NoCompression>(n, pairs, queries);
+  run<uf::BySize, uf::FullCompression>(n, pairs, queries);
+  run<uf::BySize, uf::PathHalving>(n, pairs, queries);
+  run<uf::ByRank, uf::PathHalving>(n, pairs, queries);
+  return 0;
+}
@@ -0,0 +1,150 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 unionFindBench.cc -o unionFindBench
+ *  Execution:  ./unionFindBench [n [m]]
+ *  Dependencies: unionFind.h stopwatch.h
+ *
+ *  Throughput of every UnionFind policy combination (index type, link,
+ *  compression, bounds check) on the dynamic-connectivity client loop
+ *  (find p, find q, merge if different) over m random pairs on n
+ *  elements (default: n = 1M, m = 4M). Plain quick-union without
+ *  compression is only run for small n.
+ *
+ *  % ./unionFindBench
+ *  index    link   compress   check           time Mpairs/s
+ *  uint32   naive  none       checked      skipped  (trees of linear height)
+ *  uint32   naive  none       unchecked    skipped  (trees of linear height)
+ *  uint32   naive  full       checked       0.424s      9.4  323 components
+ *  uint32   naive  full       unchecked     0.419s      9.6  323 components
+ *  uint32   naive  halving    checked       0.263s     15.2  323 components
+ *  uint32   naive  halving    unchecked     0.270s     14.8  323 components
+ *  uint32   naive  splitting  checked       0.376s     10.7  323 components
+ *  uint32   naive  splitting  unchecked     0.354s     11.3  323 components
+ *  uint32   size   none       checked       0.181s     22.1  323 components
+ *  uint32   size   none       unchecked     0.175s     22.8  323 components
+ *  uint32   size   full       checked       0.087s     45.8  323 components
+ *  uint32   size   full       unchecked     0.126s     31.7  323 components
+ *  uint32   size   halving    checked       0.076s     52.6  323 components
+ *  uint32   size   halving    unchecked     0.064s     62.6  323 components
+ *  uint32   size   splitting  checked       0.103s     38.7  323 components
+ *  uint32   size   splitting  unchecked     0.107s     37.3  323 components
+ *  uint32   rank   none       checked       0.216s     18.5  323 components
+ *  uint32   rank   none       unchecked     0.216s     18.5  323 components
+ *  uint32   rank   full       checked       0.096s     41.8  323 components
+ *  uint32   rank   full       unchecked     0.104s     38.6  323 components
+ *  uint32   rank   halving    checked       0.067s     59.4  323 components
+ *  uint32   rank   halving    unchecked     0.073s     55.1  323 components
+ *  uint32   rank   splitting  checked       0.083s     48.2  323 components
+ *  uint32   rank   splitting  unchecked     0.079s     50.4  323 components
+ *  uint64   naive  none       checked      skipped  (trees of linear height)
+ *  uint64   naive  none       unchecked    skipped  (trees of linear height)
+ *  uint64   naive  full       checked       0.576s      6.9  323 components
+ *  uint64   naive  full       unchecked     0.554s      7.2  323 components
+ *  uint64   naive  halving    checked       0.378s     10.6  323 components
+ *  uint64   naive  halving    unchecked     0.410s      9.8  323 components
+ *  uint64   naive  splitting  checked       0.524s      7.6  323 components
+ *  uint64   naive  splitting  unchecked     0.595s      6.7  323 components
+ *  uint64   size   none       checked       0.253s     15.8  323 components
+ *  uint64   size   none       unchecked     0.235s     17.1  323 components
+ *  uint64   size   full       checked       0.137s     29.2  323 components
+ *  uint64   size   full       unchecked     0.128s     31.3  323 components
+ *  uint64   size   halving    checked       0.103s     38.9  323 components
+ *  uint64   size   halving    unchecked     0.099s     40.6  323 components
+ *  uint64   size   splitting  checked       0.154s     26.0  323 components
+ *  uint64   size   splitting  unchecked     0.118s     34.0  323 components
+ *  uint64   rank   none       checked       0.245s     16.3  323 components
+ *  uint64   rank   none       unchecked     0.235s     17.0  323 components
+ *  uint64   rank   full       checked       0.110s     36.4  323 components
+ *  uint64   rank   full       unchecked     0.110s     36.2  323 components
+ *  uint64   rank   halving    checked       0.083s     48.2  323 components
+ *  uint64   rank   halving    unchecked     0.078s     51.2  323 components
+ *  uint64   rank   splitting  checked       0.130s     30.7  323 components
+ *  uint64   rank   splitting  unchecked     0.120s     33.3  323 components
+ *
+ *  (single-core machine, one run each, so differences below ~15% are
+ *  noise. The bounds check is one well-predicted branch per find and
+ *  costs next to nothing here; halving with a weighted link is fastest,
+ *  and 64-bit indices cost 20-40% through the doubled memory traffic)
+ *
+ ******************************************************************************/
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "stopwatch.h"
+#include "unionFind.h"
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> Pairs;
+
+// Largest n run without any link or compress policy, which takes
+// quadratic time.
+const size_t kMaxQuadratic = 100000;
+
+// Runs the client loop over pairs with one policy combination and
+// prints its row.
+template <typename IndexT, typename Link, typename Compress, typename Check>
+void run(size_t n, const Pairs& pairs) {
+  const char* index = sizeof(IndexT) == 4 ? "uint32" : "uint64";
+  if (std::is_same<Link, uf::Naive>::value &&
+      std::is_same<Compress, uf::NoCompression>::value && n > kMaxQuadratic) {
+    printf("%-8s %-6s %-10s %-10s %9s  (trees of linear height)\n", index,
+           Link::name(), Compress::name(), Check::name(), "skipped");
+    return;
+  }
+  Stopwatch timer;
+  UnionFind<IndexT, Link, Compress, Check> uf(n);
+  for (const auto& e : pairs) {
+    if (uf.find(e.first) != uf.find(e.second)) {
+      uf.merge(e.first, e.second);
+    }
+  }
+  double elapsed = timer.elapsedTime();
+  printf("%-8s %-6s %-10s %-10s %8.3fs %8.1f  %zu components\n",
+         index, Link::name(), Compress::name(),
+         Check::name(), elapsed, pairs.size() / elapsed / 1e6,
+         static_cast<size_t>(uf.count()));
+}
+
+template <typename IndexT, typename Link, typename Compress>
+void runChecks(size_t n, const Pairs& pairs) {
+  run<IndexT, Link, Compress, uf::Checked>(n, pairs);
+  run<IndexT, Link, Compress, uf::Unchecked>(n, pairs);
+}
+
+template <typename IndexT, typename Link>
+void runCompressions(size_t n, const Pairs& pairs) {
+  runChecks<IndexT, Link, uf::NoCompression>(n, pairs);
+  runChecks<IndexT, Link, uf::FullCompression>(n, pairs);
+  runChecks<IndexT, Link, uf::PathHalving>(n, pairs);
+  runChecks<IndexT, Link, uf::PathSplitting>(n, pairs);
+}
+
+template <typename IndexT>
+void runLinks(size_t n, const Pairs& pairs) {
+  runCompressions<IndexT, uf::Naive>(n, pairs);
+  runCompressions<IndexT, uf::BySize>(n, pairs);
+  runCompressions<IndexT, uf::ByRank>(n, pairs);
+}
+
+int main(int argc, char* argv[]) {
+  size_t n = argc > 1 ? std::stoul(argv[1]) : 1000000;
+  size_t m = argc > 2 ? std::stoul(argv[2]) : 4000000;
+
+  std::mt19937 rng(n);
+  std::uniform_int_distribution<uint32_t> element(0, n - 1);
+  Pairs pairs(m);
+  for (auto& e : pairs) {
+    e.first = element(rng);
+    e.second = element(rng);
+  }
+
+  printf("%-8s %-6s %-10s %-10s %9s %8s\n", "index", "link", "compress", "check",
+         "time", "Mpairs/s");
+  runLinks<uint32_t>(n, pairs);
+  runLinks<uint64_t>(n, pairs);
+  return 0;
+}
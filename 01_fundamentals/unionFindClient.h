@@ -0,0 +1,96 @@
+/******************************************************************************
+ *  Header:       unionFindClient.h
+ *  Dependencies: fastIO.h
+ *
+ *  The dynamic-connectivity client shared by the union-find drivers.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_UNION_FIND_CLIENT_H_
+#define FUNDAMENTALS_UNION_FIND_CLIENT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <vector>
+
+#include "fastIO.h"
+
+// Reads an integer n and a sequence of pairs of integers
+// (between 0 and n - 1 from standard input, where each integer)
+// in the pair represents some element;
+// if the elements are in different sets, merge the two sets
+// and print the pair to standard output. Finally prints the number of
+// sets. UF is any union-find type with find, merge and count.
+template <typename UF>
+void unionFindClient(In& in, Out& out) {
+  try {
+    int n = in.readInt();
+    UF uf(n);
+    while (!in.isEmpty()) {
+      int p = in.readInt();
+      int q = in.readInt();
+      if (uf.find(p) == uf.find(q)) {
+        continue;
+      }
+      uf.merge(p, q);
+      out << p << " " << q << '\n';
+    }
+    out << static_cast<long long>(uf.count()) << " components\n";
+  } catch(const std::exception& e) {
+    out << e.what() << '\n';
+  }
+}
+
+// The same client for union-find types with mergeBatch: reads the pairs
+// in blocks of up to block pairs and hands each block to mergeBatch,
+// then prints the pairs that joined two sets. The output is the same as
+// unionFindClient's, including on bad input: the pairs read before a
+// parse error, or merged before an element out of range, are printed
+// before the error message.
+template <typename UF>
+void unionFindBlockClient(In& in, Out& out, size_t block = 4096) {
+  typedef typename UF::Index Index;
+  try {
+    int n = in.readInt();
+    UF uf(n);
+    std::vector<Index> pairs(2 * block);
+    std::unique_ptr<bool[]> merged(new bool[block]);
+    while (!in.isEmpty()) {
+      size_t count = 0;
+      std::exception_ptr error;
+      try {
+        while (count < block && !in.isEmpty()) {
+          int p = in.readInt();
+          int q = in.readInt();
+          pairs[2 * count] = p;
+          pairs[2 * count + 1] = q;
+          count++;
+        }
+      } catch(const std::exception&) {
+        error = std::current_exception();
+      }
+      std::fill(merged.get(), merged.get() + count, false);
+      try {
+        uf.mergeBatch(pairs.data(), count, merged.get());
+      } catch(const std::exception&) {
+        error = std::current_exception();
+      }
+      for (size_t i = 0; i < count; i++) {
+        if (merged[i]) {
+          out << static_cast<int>(pairs[2 * i]) << " " << static_cast<int>(pairs[2 * i + 1])
+              << '\n';
+        }
+      }
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+    out << static_cast<long long>(uf.count()) << " components\n";
+  } catch(const std::exception& e) {
+    out << e.what() << '\n';
+  }
+}
+
+#endif // FUNDAMENTALS_UNION_FIND_CLIENT_H_
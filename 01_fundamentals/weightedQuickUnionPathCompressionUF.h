@@ -0,0 +1,40 @@
+/******************************************************************************
+ *  Header:       weightedQuickUnionPathCompressionUF.h
+ *  Dependencies: unionFind.h
+ *
+ *  Weighted quick-union by size with full path compression.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_WEIGHTED_QUICK_UNION_PATH_COMPRESSION_UF_H_
+#define FUNDAMENTALS_WEIGHTED_QUICK_UNION_PATH_COMPRESSION_UF_H_
+
+#include <cstdint>
+
+#include "unionFind.h"
+
+ /**
+  * The WeightedQuickUnionPathCompressionUF class represents a union-find data type
+  * (also known as the disjoint-sets data type).
+  * It supports the classic union and find operations,
+  * along with a count operation that returns the total number of sets.
+  *
+  * This implementation uses weighted quick union by size without full path compression.
+  * The constructor takes theta(n) time, where n is the number of sites.
+  * The find, and union operatoins take theta(log(n)) time in the worse case;
+  * the count operation takes theta(1) time.
+  * Moreover, starting from an empty data structure with n sites, any
+  * intermixed sequence of m union and find operatons take alpha(n) time,
+  * where alpha(n) is the inverse of https://en.wikipedia.org/wiki/Ackermann_function#Inverse.
+  * AKA Ackermann's function.
+  *
+  * For additional documentation, see https://algs4.cs.princeton.edu/15uf.
+  * 
+  * @author xjliang
+  * @date   Fri Dec  4 15:18:43 CST 2020
+  */
+
+typedef UnionFind<uint32_t, uf::BySize, uf::FullCompression, uf::Checked>
+    WeightedQuickUnionPathCompressionUF;
+
+#endif // FUNDAMENTALS_WEIGHTED_QUICK_UNION_PATH_COMPRESSION_UF_H_
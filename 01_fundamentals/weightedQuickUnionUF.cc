@@ -1,7 +1,7 @@
 /******************************************************************************
  *  Compilation:  g++ weightedQuickUnionUF.cc -o weightedQuickUnionUF
  *  Execution:  ./weightedQuickUnionUF < input.txt
- *  Dependencies:
+ *  Dependencies: unionFind.h unionFindClient.h fastIO.h opStats.h
  *  Data files:   https://algs4.cs.princeton.edu/15uf/tinyUF.txt
  *                https://algs4.cs.princeton.edu/15uf/mediumUF.txt
  *                https://algs4.cs.princeton.edu/15uf/largeUF.txt
@@ -10,9 +10,12 @@
  *
  ******************************************************************************/
 
-#include <iostream>
-#include <vector>
-#include <stdexcept>
+#include <cstdint>
+
+#include "fastIO.h"
+#include "opStats.h"
+#include "unionFind.h"
+#include "unionFindClient.h"
 
  /**
   * The WeightedWeightedQuickUnionUF class represents a union-find data type
@@ -58,68 +61,8 @@
   * @date   Fri Dec  4 15:18:43 CST 2020
   */
 
-class WeightedQuickUnionUF {
- public:
-  // Initializes an empty union-find data structure with n elements
-  // 0 through n - 1. Initially, each element is in its own set.
-  WeightedQuickUnionUF(int n) : count_(n) {
-    parent_.reserve(n);
-    size_.reserve(n);
-    for (int i = 0; i < n; i++) {
-      parent_.push_back(i);
-      size_.push_back(1);
-    }
-  }
-
-  ~WeightedQuickUnionUF() { }
-
-  // Returns the number of sets.
-  int count() const { return count_; }
-
-  // Returns the canonical element of the set containing element p.
-  int find(int p) {
-    validate(p);
-    while (p != parent_[p]) {
-      p = parent_[p];
-    }
-    return p;
-  }
-
-  // Merges the set containing element p with the set containing element q.
-  void merge(int p, int q) {
-    int root_p = find(p);
-    int root_q = find(q);
-    if (root_p == root_q) {
-      return;
-    }
-
-    // make smaller root pointer to larger one
-    if (size_[root_p] < size_[root_q]) {
-      parent_[root_p] = parent_[root_q];
-      size_[root_q] += size_[root_p];
-    } else {
-      parent_[root_q] = parent_[root_p];
-      size_[root_p] += size_[root_q];
-    }
-    count_--;
-  }
-
- private:
-  // Validates tha p is a valid index.
-  void validate(int p) {
-    int n = parent_.size();
-    if (p < 0 || p >= n) {
-      char msg[80];
-      sprintf(msg, "index %d is not between 0 and %d", p, n - 1);
-      throw new std::out_of_range(msg);
-    }
-  }
-
- private:
-  std::vector<int> parent_;   // parent_[i] = parent of i
-  std::vector<int> size_;     // size_[i] = number of elements in subtree rooted in i
-  int count_;                 // number of components
-}; // class WeightedQuickUnionUF
+typedef UnionFind<uint32_t, uf::BySize, uf::NoCompression, uf::Checked>
+    WeightedQuickUnionUF;
 
 
 // Reads an integer n and a sequence of pairs of integers
@@ -128,24 +71,9 @@ class WeightedQuickUnionUF {
 // if the elements are in different sets, merge the two sets
 // and print the pair to standard output.
 int main(int argc, char* argv[]) {
-  int n;
-  std::cin >> n;
-  WeightedQuickUnionUF uf(n);
-
-  int p;
-  int q;
-  try {
-    while (std::cin >> p >> q) {
-      if (uf.find(p) == uf.find(q)) {
-        continue;
-      }
-      uf.merge(p, q);
-      std::cout << p << " " << q << std::endl;
-    }
-    std::cout << uf.count() << " components" << std::endl;
-  } catch(const std::exception& e) {
-    std::cout << e.what() << std::endl;
-  }
-
-  return 0;
+  opstats::dumpJsonAtExit();
+  In in;
+  Out out;
+  unionFindBlockClient<WeightedQuickUnionUF>(in, out);
+  return out.exitStatus();
 }
@@ -0,0 +1,178 @@
+/******************************************************************************
+ *  Header:       workloads.h
+ *  Dependencies:
+ *
+ *  Deterministic generators of union-find and allowlist workloads for
+ *  the benchmarks.
+ *
+ ******************************************************************************/
+
+#ifndef FUNDAMENTALS_WORKLOADS_H_
+#define FUNDAMENTALS_WORKLOADS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Every generator is a pure function of its arguments: the random
+ * choices come from a counter-based generator (splitmix64 of a seeded
+ * counter) and are mapped to ranges without the standard distributions,
+ * whose output differs between standard libraries. So a workload is the
+ * same on every machine and compiler, and a number measured today can
+ * be compared with one measured next month.
+ */
+
+namespace workload {
+
+typedef std::vector<std::pair<uint32_t, uint32_t>> Pairs;
+
+// A union-find input: n elements and the pairs to connect, in order.
+struct UnionFindWorkload {
+  std::string name;
+  size_t n;
+  Pairs pairs;
+};
+
+// Returns the i-th pseudo-random 64-bit value of stream seed (splitmix64).
+inline uint64_t mix(uint64_t seed, uint64_t i) {
+  uint64_t z = (seed * 0x2545f4914f6cdd1dULL + i) * 0x9e3779b97f4a7c15ULL;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// Maps a 64-bit value onto [0, n) without a division.
+inline uint64_t below(uint64_t x, uint64_t n) {
+  return static_cast<uint64_t>((static_cast<unsigned __int128>(x) * n) >> 64);
+}
+
+// Shuffles a[0..n) with the Fisher-Yates algorithm on stream seed.
+template <typename T>
+void shuffle(T* a, size_t n, uint64_t seed) {
+  for (size_t i = n; i > 1; i--) {
+    std::swap(a[i - 1], a[below(mix(seed, i), i)]);
+  }
+}
+
+// m pairs of elements drawn uniformly from [0, n); n must be positive
+// if m is.
+inline UnionFindWorkload random(size_t n, size_t m, uint64_t seed = 1) {
+  UnionFindWorkload w = { "random", n, Pairs(m) };
+  for (size_t i = 0; i < m; i++) {
+    w.pairs[i].first = below(mix(seed, 2 * i), n);
+    w.pairs[i].second = below(mix(seed, 2 * i + 1), n);
+  }
+  return w;
+}
+
+// The pairs (0, 1), (0, 2), ..., (0, n - 1). Plain quick-union hangs
+// each root below the next, so the path from 0 grows by one per pair
+// and the client loop takes quadratic time; quick-find relabels a set
+// that grows by one per pair, also quadratic.
+inline UnionFindWorkload chain(size_t n) {
+  UnionFindWorkload w = { "chain", n, Pairs() };
+  for (size_t i = 1; i < n; i++) {
+    w.pairs.push_back(std::make_pair(0, static_cast<uint32_t>(i)));
+  }
+  return w;
+}
+
+// Site percolation on a side-by-side grid: sites open in random order
+// until a fraction p of them is open (above the threshold of about
+// 0.593, so a spanning cluster forms), and each opening connects the
+// site to its open neighbours, as the percolation client does.
+inline UnionFindWorkload grid(size_t side, double p = 0.6, uint64_t seed = 1) {
+  size_t n = side * side;
+  UnionFindWorkload w = { "grid", n, Pairs() };
+  std::vector<uint32_t> order(n);
+  for (size_t i = 0; i < n; i++) {
+    order[i] = static_cast<uint32_t>(i);
+  }
+  shuffle(order.data(), n, seed);
+  std::vector<bool> open(n, false);
+  size_t opened = static_cast<size_t>(p * n);
+  for (size_t k = 0; k < opened; k++) {
+    uint32_t s = order[k];
+    size_t row = s / side;
+    size_t col = s % side;
+    open[s] = true;
+    if (row > 0 && open[s - side]) {
+      w.pairs.push_back(std::make_pair(s, static_cast<uint32_t>(s - side)));
+    }
+    if (row + 1 < side && open[s + side]) {
+      w.pairs.push_back(std::make_pair(s, static_cast<uint32_t>(s + side)));
+    }
+    if (col > 0 && open[s - 1]) {
+      w.pairs.push_back(std::make_pair(s, s - 1));
+    }
+    if (col + 1 < side && open[s + 1]) {
+      w.pairs.push_back(std::make_pair(s, s + 1));
+    }
+  }
+  return w;
+}
+
+// m edges of a graph with power-law degrees: both endpoints have rank r
+// with probability about 1 / ((r + 1) ln n), so a few hubs take most
+// edges and most elements take one or none. Ranks are scattered over
+// the ids so that the hubs are not all at the front of the arrays. n
+// must be positive if m is.
+inline UnionFindWorkload powerLaw(size_t n, size_t m, uint64_t seed = 1) {
+  UnionFindWorkload w = { "powerlaw", n, Pairs(m) };
+  // a stride coprime to n makes r -> r * stride mod n a permutation
+  uint64_t stride = n > 1 ? 0x9e3779b97f4a7c15ULL % n : 1;
+  while (n > 1 && (stride == 0 || std::gcd(stride, static_cast<uint64_t>(n)) != 1)) {
+    stride++;
+  }
+  double log_n = std::log(static_cast<double>(n));
+  auto endpoint = [&](uint64_t i) {
+    double u = (mix(seed, i) >> 11) * (1.0 / 9007199254740992.0);
+    uint64_t r = static_cast<uint64_t>(std::exp(u * log_n)) - 1;
+    r = std::min<uint64_t>(r, n - 1);
+    return static_cast<uint32_t>(static_cast<unsigned __int128>(r) * stride % n);
+  };
+  for (size_t i = 0; i < m; i++) {
+    w.pairs[i].first = endpoint(2 * i);
+    w.pairs[i].second = endpoint(2 * i + 1);
+  }
+  return w;
+}
+
+// Returns about n distinct keys drawn from [0, 16n), sorted: a dense
+// enough allowlist that every membership backend applies.
+inline std::vector<int> allowlist(size_t n, uint64_t seed = 1) {
+  std::vector<int> keys(n);
+  for (size_t i = 0; i < n; i++) {
+    keys[i] = static_cast<int>(below(mix(seed, i), 16 * n));
+  }
+  std::sort(keys.begin(), keys.end());
+  keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+  return keys;
+}
+
+// Returns m queries against the sorted keys, a fraction hits of them
+// keys of the allowlist and the rest drawn from its whole range.
+inline std::vector<int> queries(const std::vector<int>& keys, size_t m, double hits,
+                                uint64_t seed = 2) {
+  std::vector<int> q(m);
+  uint64_t range = keys.empty() ? 1 : static_cast<uint64_t>(keys.back()) + 1;
+  uint64_t threshold = static_cast<uint64_t>(hits * 18446744073709551615.0);
+  for (size_t i = 0; i < m; i++) {
+    if (!keys.empty() && mix(seed, 2 * i) < threshold) {
+      q[i] = keys[below(mix(seed, 2 * i + 1), keys.size())];
+    } else {
+      q[i] = static_cast<int>(below(mix(seed, 2 * i + 1), range));
+    }
+  }
+  return q;
+}
+
+} // namespace workload
+
+#endif // FUNDAMENTALS_WORKLOADS_H_
@@ -0,0 +1,166 @@
+/******************************************************************************
+ *  Header:       edgeArray.h
+ *  Dependencies: fastIO.h
+ *
+ *  Edge-weighted graphs as one flat array of 12-byte edges, read from
+ *  algs4 text files or from a binary file that is the array itself.
+ *
+ ******************************************************************************/
+
+#ifndef GRAPHS_EDGE_ARRAY_H_
+#define GRAPHS_EDGE_ARRAY_H_
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../01_fundamentals/fastIO.h"
+
+// An edge v-w of the given weight. Endpoints are 32-bit and the weight a
+// float, so that an edge takes 12 bytes and 100 million edges 1.2 GB.
+struct WeightedEdge {
+  uint32_t v;
+  uint32_t w;
+  float weight;
+};
+static_assert(sizeof(WeightedEdge) == 12, "an edge must take 12 bytes");
+
+// An edge-weighted graph on the vertices 0 through vertices - 1: the
+// edges in no particular order, parallel edges and self-loops allowed.
+struct EdgeArray {
+  uint32_t vertices = 0;
+  std::vector<WeightedEdge> edges;
+};
+
+/**
+ * A binary edge file holds the array as it is in memory, in native byte
+ * order, so that loading it is one read:
+ *
+ *   offset 0    edgearray::Header (32 bytes)
+ *   offset 32   edges[0..count), 12 bytes each
+ */
+
+namespace edgearray {
+
+const char kMagic[8] = { 'A', 'L', 'G', 'S', '4', 'E', 'W', 'G' };
+const uint32_t kVersion = 1;
+
+struct Header {
+  char magic[8];       // kMagic
+  uint32_t version;    // kVersion
+  uint32_t vertices;   // number of vertices
+  uint64_t count;      // number of edges
+  uint64_t reserved;   // 0
+};
+static_assert(sizeof(Header) == 32, "edge file header must take 32 bytes");
+
+// Throws std::runtime_error if an edge of g has an endpoint out of range
+// or a NaN weight.
+inline void validate(const EdgeArray& g, const std::string& source) {
+  for (size_t i = 0; i < g.edges.size(); i++) {
+    if (g.edges[i].v >= g.vertices || g.edges[i].w >= g.vertices) {
+      throw std::runtime_error(source + ": edge " + std::to_string(i) +
+                               " has an endpoint out of range");
+    }
+    if (std::isnan(g.edges[i].weight)) {
+      throw std::runtime_error(source + ": edge " + std::to_string(i) + " has a NaN weight");
+    }
+  }
+}
+
+} // namespace edgearray
+
+// Reads a graph in the algs4 text format: the number of vertices, the
+// number of edges, then one "v w weight" triple per edge. Throws
+// std::runtime_error if the input is malformed.
+inline EdgeArray readEdgeArray(In& in) {
+  EdgeArray g;
+  int vertices = in.readInt();
+  int count = in.readInt();
+  if (vertices < 0 || count < 0) {
+    throw std::runtime_error("the numbers of vertices and edges must be nonnegative");
+  }
+  g.vertices = static_cast<uint32_t>(vertices);
+  g.edges.resize(count);
+  for (WeightedEdge& e : g.edges) {
+    e.v = static_cast<uint32_t>(in.readInt());
+    e.w = static_cast<uint32_t>(in.readInt());
+    std::string weight = in.readString();
+    char* end;
+    e.weight = strtof(weight.c_str(), &end);
+    if (weight.empty() || *end != '\0' || std::isnan(e.weight)) {
+      throw std::runtime_error("bad weight '" + weight + "'");
+    }
+  }
+  edgearray::validate(g, "input");
+  return g;
+}
+
+// Reads a binary edge file. Throws std::runtime_error if it cannot be
+// read, is not an edge file, does not hold exactly its edges or holds an
+// invalid one.
+inline EdgeArray readEdgeFile(const char* path) {
+  FILE* f = fopen(path, "rb");
+  if (f == nullptr) {
+    throw std::runtime_error(std::string(path) + ": " + strerror(errno));
+  }
+  EdgeArray g;
+  try {
+    edgearray::Header h;
+    if (fread(&h, sizeof(h), 1, f) != 1 ||
+        memcmp(h.magic, edgearray::kMagic, sizeof(h.magic)) != 0) {
+      throw std::runtime_error(std::string(path) + ": not an edge file");
+    }
+    if (h.version != edgearray::kVersion) {
+      throw std::runtime_error(std::string(path) + ": unsupported version " +
+                               std::to_string(h.version));
+    }
+    struct stat st;
+    if (fstat(fileno(f), &st) != 0 || static_cast<uint64_t>(st.st_size) - sizeof(h) !=
+                                          h.count * sizeof(WeightedEdge)) {
+      throw std::runtime_error(std::string(path) + ": size does not match the edge count");
+    }
+    g.vertices = h.vertices;
+    g.edges.resize(h.count);
+    if (fread(g.edges.data(), sizeof(WeightedEdge), h.count, f) != h.count) {
+      throw std::runtime_error(std::string(path) + ": truncated");
+    }
+  } catch (...) {
+    fclose(f);
+    throw;
+  }
+  fclose(f);
+  edgearray::validate(g, path);
+  return g;
+}
+
+// Writes g as a binary edge file. Throws std::runtime_error on failure.
+inline void writeEdgeFile(const char* path, const EdgeArray& g) {
+  FILE* f = fopen(path, "wb");
+  if (f == nullptr) {
+    throw std::runtime_error(std::string(path) + ": " + strerror(errno));
+  }
+  edgearray::Header h;
+  memcpy(h.magic, edgearray::kMagic, sizeof(h.magic));
+  h.version = edgearray::kVersion;
+  h.vertices = g.vertices;
+  h.count = g.edges.size();
+  h.reserved = 0;
+  bool ok = fwrite(&h, sizeof(h), 1, f) == 1 &&
+            fwrite(g.edges.data(), sizeof(WeightedEdge), g.edges.size(), f) == g.edges.size();
+  ok = fclose(f) == 0 && ok;
+  if (!ok) {
+    throw std::runtime_error(std::string(path) + ": write failed");
+  }
+}
+
+#endif // GRAPHS_EDGE_ARRAY_H_
@@ -0,0 +1,53 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread kruskalMST.cc -o kruskalMST
+ *  Execution:  ./kruskalMST < input.txt
+ *              ./kruskalMST edges.ewg
+ *  Dependencies: kruskalMST.h edgeArray.h unionFind.h radixSort.h
+ *                parallel.h fastIO.h
+ *  Data files:   https://algs4.cs.princeton.edu/43mst/tinyEWG.txt
+ *                https://algs4.cs.princeton.edu/43mst/mediumEWG.txt
+ *                https://algs4.cs.princeton.edu/43mst/largeEWG.txt
+ *
+ *  Computes a minimum spanning forest of an edge-weighted graph, read in
+ *  the algs4 text format from standard input or from a binary edge file
+ *  (see edgeArray.h, and kruskalMSTBench gen), and prints its edges and
+ *  its weight.
+ *
+ *  % ./kruskalMST < tinyEWG.txt
+ *  0-7 0.16000
+ *  2-3 0.17000
+ *  1-7 0.19000
+ *  0-2 0.26000
+ *  5-7 0.28000
+ *  4-5 0.35000
+ *  6-2 0.40000
+ *  1.81000
+ *
+ ******************************************************************************/
+
+#include <cstdio>
+#include <exception>
+
+#include "edgeArray.h"
+#include "kruskalMST.h"
+
+int main(int argc, char* argv[]) {
+  try {
+    EdgeArray g;
+    if (argc > 1) {
+      g = readEdgeFile(argv[1]);
+    } else {
+      In in;
+      g = readEdgeArray(in);
+    }
+    KruskalMST mst(&g);
+    for (const WeightedEdge& e : mst.edges()) {
+      printf("%u-%u %.5f\n", e.v, e.w, e.weight);
+    }
+    printf("%.5f\n", mst.weight());
+  } catch (const std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,178 @@
+/******************************************************************************
+ *  Header:       kruskalMST.h
+ *  Dependencies: edgeArray.h unionFind.h radixSort.h parallel.h
+ *
+ *  Minimum spanning forest by Filter-Kruskal: Kruskal's algorithm that
+ *  only sorts the edges it cannot rule out first.
+ *
+ ******************************************************************************/
+
+#ifndef GRAPHS_KRUSKAL_MST_H_
+#define GRAPHS_KRUSKAL_MST_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include "../01_fundamentals/parallel.h"
+#include "../01_fundamentals/radixSort.h"
+#include "../01_fundamentals/unionFind.h"
+#include "edgeArray.h"
+
+ /**
+  * The KruskalMST class computes a minimum spanning forest of an
+  * edge-weighted graph: a minimum spanning tree of each of its connected
+  * components.
+  *
+  * Kruskal's algorithm takes the edges in ascending order of weight and
+  * keeps those joining two different trees, which a union-find (weighted
+  * quick-union with path compression) tells. Sorting all the edges first
+  * is the bulk of the work, yet on a graph with many more edges than
+  * vertices the forest is complete long before the heaviest edges come
+  * up. Filter-Kruskal (Osipov, Sanders and Singler, 2009) sorts only what
+  * it has to:
+  *
+  *   - the edges are partitioned around the median weight of a sample;
+  *     the light half is processed first, recursively;
+  *   - the heavy half is then filtered: an edge whose endpoints the light
+  *     half already connected can never join the forest and is dropped,
+  *     at the cost of two finds;
+  *   - the survivors are processed recursively, and small enough parts
+  *     are sorted, with the parallel radixSort on the float weights, and
+  *     run through plain Kruskal.
+  *
+  * It stops as soon as the forest is a spanning tree. The finds of the
+  * filter and of Kruskal follow the edges in order, so the parent slots
+  * of the endpoints a few edges ahead are prefetched.
+  *
+  * The weights must not be NaN. The forest has the edges in ascending
+  * order of weight; among edges of equal weight which ones are kept is
+  * unspecified, but the weight of the forest is not.
+  *
+  * For additional documentation, see https://algs4.cs.princeton.edu/43mst.
+  */
+
+class KruskalMST {
+ public:
+  typedef UnionFind<uint32_t, uf::BySize, uf::FullCompression, uf::Unchecked> UF;
+
+  // Computes a minimum spanning forest of *g, rearranging and dropping
+  // its edges in the process, with the given number of threads for the
+  // sorts. Throws std::invalid_argument if an edge has an endpoint out
+  // of range.
+  explicit KruskalMST(EdgeArray* g, int threads = defaultThreads())
+      : uf_(g->vertices), threads_(threads), weight_(0), sorted_(0) {
+    for (const WeightedEdge& e : g->edges) {
+      if (e.v >= g->vertices || e.w >= g->vertices) {
+        throw std::invalid_argument("edge endpoint out of range");
+      }
+    }
+    base_ = std::max<size_t>(kMinBase, g->vertices);
+    if (g->vertices > 0) {
+      mst_.reserve(g->vertices - 1);
+    }
+    filterKruskal(g->edges.data(), g->edges.data() + g->edges.size());
+    for (const WeightedEdge& e : mst_) {
+      weight_ += e.weight;
+    }
+  }
+
+  // Returns the edges of the forest, in ascending order of weight.
+  const std::vector<WeightedEdge>& edges() const { return mst_; }
+
+  // Returns the sum of the weights of the edges of the forest.
+  double weight() const { return weight_; }
+
+  // Returns the number of edges that were sorted; the others were all
+  // filtered out, or left unseen once the tree was complete.
+  size_t sorted() const { return sorted_; }
+
+ private:
+  // Parts with at most max(kMinBase, V) edges are sorted outright.
+  static constexpr size_t kMinBase = 1 << 16;
+  // Weights sampled to choose a pivot.
+  static constexpr size_t kSample = 1023;
+  // Edges whose endpoints are prefetched ahead of the finds.
+  static constexpr size_t kAhead = 8;
+
+  bool complete() const { return uf_.count() <= 1; }
+
+  void prefetchEnds(const WeightedEdge* e, const WeightedEdge* hi) const {
+    if (hi - e > static_cast<ptrdiff_t>(kAhead)) {
+      uf_.prefetch(e[kAhead].v);
+      uf_.prefetch(e[kAhead].w);
+    }
+  }
+
+  void filterKruskal(WeightedEdge* lo, WeightedEdge* hi) {
+    while (!complete() && lo != hi) {
+      if (static_cast<size_t>(hi - lo) <= base_) {
+        kruskal(lo, hi);
+        return;
+      }
+      float pivot = samplePivot(lo, hi);
+      WeightedEdge* mid =
+          std::partition(lo, hi, [pivot](const WeightedEdge& e) { return e.weight <= pivot; });
+      if (mid == hi) {
+        // the pivot is the largest weight: nothing to split off
+        kruskal(lo, hi);
+        return;
+      }
+      filterKruskal(lo, mid);
+      lo = mid;
+      hi = filter(mid, hi);
+    }
+  }
+
+  // Returns the median of kSample weights of [lo, hi), evenly spaced.
+  static float samplePivot(const WeightedEdge* lo, const WeightedEdge* hi) {
+    size_t n = hi - lo;
+    std::vector<float> sample(kSample);
+    for (size_t k = 0; k < kSample; k++) {
+      sample[k] = lo[k * n / kSample].weight;
+    }
+    std::nth_element(sample.begin(), sample.begin() + kSample / 2, sample.end());
+    return sample[kSample / 2];
+  }
+
+  // Moves the edges of [lo, hi) joining different trees to the front, in
+  // order, and returns the end of them.
+  WeightedEdge* filter(WeightedEdge* lo, WeightedEdge* hi) {
+    WeightedEdge* out = lo;
+    for (WeightedEdge* e = lo; e != hi; e++) {
+      prefetchEnds(e, hi);
+      if (uf_.find(e->v) != uf_.find(e->w)) {
+        *out++ = *e;
+      }
+    }
+    return out;
+  }
+
+  // Sorts [lo, hi) by weight and adds the edges that join different
+  // trees to the forest.
+  void kruskal(WeightedEdge* lo, WeightedEdge* hi) {
+    radixSort(lo, hi, [](const WeightedEdge& e) { return radix::floatKey(e.weight); },
+              threads_);
+    sorted_ += hi - lo;
+    for (WeightedEdge* e = lo; e != hi && !complete(); e++) {
+      prefetchEnds(e, hi);
+      uint32_t a = uf_.find(e->v);
+      uint32_t b = uf_.find(e->w);
+      if (a != b) {
+        uf_.mergeRoots(a, b);
+        mst_.push_back(*e);
+      }
+    }
+  }
+
+  UF uf_;                           // the trees of the forest so far
+  int threads_;                     // threads for the sorts
+  size_t base_;                     // largest part sorted outright
+  std::vector<WeightedEdge> mst_;   // edges of the forest
+  double weight_;                   // their total weight
+  size_t sorted_;                   // edges sorted
+}; // class KruskalMST
+
+#endif // GRAPHS_KRUSKAL_MST_H_
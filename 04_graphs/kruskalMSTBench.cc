@@ -0,0 +1,166 @@
+/******************************************************************************
+ *  Compilation:  g++ -O2 -pthread kruskalMSTBench.cc -o kruskalMSTBench
+ *  Execution:  ./kruskalMSTBench [m [threads]]
+ *              ./kruskalMSTBench gen random|geometric m edges.ewg
+ *  Dependencies: kruskalMST.h edgeArray.h weightedQuickUnionPathCompressionUF.h
+ *                unionFind.h radixSort.h parallel.h workloads.h stopwatch.h
+ *
+ *  Minimum spanning forests of graphs with m edges (default 100M) on
+ *  m / 10 vertices: the naive Kruskal, which sorts all the edges with
+ *  std::sort and then merges them in a WeightedQuickUnionPathCompressionUF
+ *  until the tree is complete, against KruskalMST on one thread and on
+ *  the given number of threads (default: one per hardware thread). Both
+ *  must find forests of the same weight. The graphs are generated
+ *  deterministically; gen writes one as a binary edge file, for
+ *  kruskalMST.
+ *
+ *    - random:     uniformly random endpoints and weights in [0, 1)
+ *    - geometric:  vertices on a jittered square lattice, each joined to
+ *                  random vertices at most 3 cells away, weighted by
+ *                  distance
+ *
+ *  % ./kruskalMSTBench
+ *  graph               V           E   sorted    naive   mst, 1 thread  mst, 1 threads         weight
+ *  random       10000000   100000000    14.2%   21.75s    7.54s  2.89x    7.32s  2.97x    601062.3279
+ *  geometric    10000000   100000000    20.8%   19.22s    5.84s  3.29x    5.72s  3.36x  11409394.3704
+ *
+ *  (single-core machine, so the threads column only shows the cost of
+ *  the fork-join. The sorted column is the share of the edges that
+ *  KruskalMST sorted; the rest were filtered out or never reached)
+ *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../01_fundamentals/stopwatch.h"
+#include "../01_fundamentals/weightedQuickUnionPathCompressionUF.h"
+#include "../01_fundamentals/workloads.h"
+#include "edgeArray.h"
+#include "kruskalMST.h"
+
+// Returns a float in [0, 1) from 24 random bits.
+float unit(uint64_t x) { return static_cast<float>(x >> 40) * (1.0f / (1 << 24)); }
+
+EdgeArray randomGraph(uint32_t n, size_t m) {
+  EdgeArray g;
+  g.vertices = n;
+  g.edges.resize(m);
+  parallelFor(0, m, defaultThreads(), [&](long long k) {
+    g.edges[k].v = static_cast<uint32_t>(workload::below(workload::mix(1, 3 * k), n));
+    g.edges[k].w = static_cast<uint32_t>(workload::below(workload::mix(1, 3 * k + 1), n));
+    g.edges[k].weight = unit(workload::mix(1, 3 * k + 2));
+  });
+  return g;
+}
+
+EdgeArray geometricGraph(uint32_t n, size_t m) {
+  const long kReach = 3;
+  EdgeArray g;
+  g.vertices = n;
+  g.edges.resize(m);
+  const long side = static_cast<long>(std::ceil(std::sqrt(static_cast<double>(n))));
+  auto x = [&](long i) { return i % side + unit(workload::mix(2, 2 * i)); };
+  auto y = [&](long i) { return i / side + unit(workload::mix(2, 2 * i + 1)); };
+  parallelFor(0, m, defaultThreads(), [&](long long k) {
+    long v = static_cast<long>(k % n);
+    uint64_t r = workload::mix(3, k);
+    long cx = v % side + static_cast<long>(r % (2 * kReach + 1)) - kReach;
+    long cy = v / side + static_cast<long>(r / 16 % (2 * kReach + 1)) - kReach;
+    cx = std::min(std::max(cx, 0L), side - 1);
+    cy = std::min(std::max(cy, 0L), side - 1);
+    long w = std::min(cy * side + cx, static_cast<long>(n) - 1);
+    g.edges[k].v = static_cast<uint32_t>(v);
+    g.edges[k].w = static_cast<uint32_t>(w);
+    g.edges[k].weight = std::hypot(x(v) - x(w), y(v) - y(w));
+  });
+  return g;
+}
+
+EdgeArray generate(const std::string& name, size_t m) {
+  uint32_t n = static_cast<uint32_t>(std::max<size_t>(m / 10, 2));
+  if (name == "random") {
+    return randomGraph(n, m);
+  }
+  if (name == "geometric") {
+    return geometricGraph(n, m);
+  }
+  throw std::invalid_argument("unknown graph " + name);
+}
+
+// Kruskal's algorithm on all the edges, sorted first; returns the weight
+// of the forest and its number of edges.
+double naiveKruskal(EdgeArray* g, size_t* edges) {
+  std::vector<WeightedEdge>& a = g->edges;
+  std::sort(a.begin(), a.end(), [](const WeightedEdge& e, const WeightedEdge& f) {
+    return e.weight < f.weight;
+  });
+  WeightedQuickUnionPathCompressionUF uf(g->vertices);
+  double weight = 0;
+  *edges = 0;
+  for (size_t i = 0; i < a.size() && uf.count() > 1; i++) {
+    if (uf.merge(a[i].v, a[i].w)) {
+      weight += a[i].weight;
+      ++*edges;
+    }
+  }
+  return weight;
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    if (argc > 1 && strcmp(argv[1], "gen") == 0) {
+      if (argc < 5) {
+        fprintf(stderr, "usage: %s gen random|geometric m edges.ewg\n", argv[0]);
+        return 1;
+      }
+      writeEdgeFile(argv[4], generate(argv[2], std::stoull(argv[3])));
+      return 0;
+    }
+    size_t m = argc > 1 ? std::stoull(argv[1]) : 100000000;
+    int threads = argc > 2 ? std::stoi(argv[2]) : defaultThreads();
+    printf("%-10s %10s %11s %8s %8s %15s %15s %14s\n", "graph", "V", "E", "sorted", "naive",
+           "mst, 1 thread", ("mst, " + std::to_string(threads) + " threads").c_str(),
+           "weight");
+    for (const char* name : { "random", "geometric" }) {
+      EdgeArray g = generate(name, m);
+
+      EdgeArray copy = g;
+      Stopwatch naive_timer;
+      size_t naive_edges;
+      double naive_weight = naiveKruskal(&copy, &naive_edges);
+      double naive = naive_timer.elapsedTime();
+
+      copy = g;
+      Stopwatch one_timer;
+      KruskalMST one(&copy, 1);
+      double mst_one = one_timer.elapsedTime();
+
+      copy = g;
+      Stopwatch many_timer;
+      KruskalMST many(&copy, threads);
+      double mst_many = many_timer.elapsedTime();
+
+      if (one.weight() != naive_weight || many.weight() != naive_weight ||
+          one.edges().size() != naive_edges || many.edges().size() != naive_edges) {
+        fprintf(stderr, "%s: forests of weight %.6f and %.6f, expected %.6f\n", name,
+                one.weight(), many.weight(), naive_weight);
+        return 1;
+      }
+      printf("%-10s %10u %11zu %7.1f%% %7.2fs %7.2fs %5.2fx %7.2fs %5.2fx %14.4f\n", name,
+             g.vertices, g.edges.size(), 100.0 * one.sorted() / g.edges.size(), naive, mst_one,
+             naive / mst_one, mst_many, naive / mst_many, naive_weight);
+    }
+  } catch (const std::exception& e) {
+    fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}